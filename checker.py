@@ -8,25 +8,28 @@ def main():
   cpps = []
   for (p, _, fs) in walk(path):
     for f in fs:
-      if f.endswith('.cpp') and 'Test' not in f and 'main' not in f:
+      if f.endswith('.cpp') and 'Test' not in f and 'main' not in f and f != 'Sim.cpp':
         cpps.append(pathjoin(p, f))
 
   cpps = set(cpps)
 
   cmake_cpps = []
+  lists = ('set(SIM_FILES', 'set(GAME_FILES')
   with open('CMakeLists.txt') as f:
     it = iter(f)
+    found = 0
     for l in it:
-      if 'set(SRC_FILES' in l:
-        break
-    else:
-      print("'set(SRC_FILES' not found")
+      if not any(name in l for name in lists):
+        continue
+      found += 1
+      for l in it:
+        if ')' in l:
+          break
+        else:
+          cmake_cpps.append(l.strip())
+    if found != len(lists):
+      print("'set(SIM_FILES' or 'set(GAME_FILES' not found")
       sys.exit(0)
-    for l in it:
-      if ')' in l:
-        break
-      else:
-        cmake_cpps.append(l.strip())
   
   cmake_cpps = set(cmake_cpps)
 
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "ECS/Event.h"
+
+#include <glm/vec2.hpp>
+
+// Emitted by the simulation for whoever draws it; nothing in the simulation listens
+
+struct ShotEvent {
+  ShotEvent(glm::vec2 from, glm::vec2 to) : from(from), to(to) {}
+  glm::vec2 from, to;
+};
+
+struct DeathEvent {
+  DeathEvent(glm::vec2 pos) : pos(pos) {}
+  glm::vec2 pos;
+};
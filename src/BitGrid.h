@@ -0,0 +1,193 @@
+#pragma once
+
+#include <glm/common.hpp>
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A 2D grid of bits packed into 64-bit words
+ * @detail Rows run along y and each row is padded to a whole number of words, so counts, rectangle
+ * tests and searches for the next set cell handle 64 tiles per operation.
+ */
+class BitGrid {
+public:
+  using Word = std::uint64_t;
+  static constexpr int word_bits = 64;
+
+private:
+  int _width;
+  int _height;
+  int _wordsPerRow;
+  std::vector<Word> _words;
+
+public:
+  BitGrid(int width = 0, int height = 0, bool value = false)
+      : _width(width), _height(height), _wordsPerRow((width + word_bits - 1) / word_bits),
+        _words(static_cast<std::size_t>(_wordsPerRow) * height, 0) {
+    if (value) {
+      fill(true);
+    }
+  }
+
+  int width() const {
+    return _width;
+  }
+
+  int height() const {
+    return _height;
+  }
+
+  bool inBounds(glm::ivec2 p) const {
+    return p.x >= 0 && p.y >= 0 && p.x < _width && p.y < _height;
+  }
+
+  /// out of bounds cells read as unset
+  bool get(glm::ivec2 p) const {
+    if (not inBounds(p)) {
+      return false;
+    }
+    return (_words[_index(p)] >> (p.x % word_bits)) & 1;
+  }
+
+  void set(glm::ivec2 p, bool value) {
+    if (not inBounds(p)) {
+      return;
+    }
+    const Word mask = Word(1) << (p.x % word_bits);
+    if (value) {
+      _words[_index(p)] |= mask;
+    } else {
+      _words[_index(p)] &= ~mask;
+    }
+  }
+
+  void fill(bool value) {
+    for (int y = 0; y < _height; ++y) {
+      Word* row = &_words[static_cast<std::size_t>(y) * _wordsPerRow];
+      for (int w = 0; w < _wordsPerRow; ++w) {
+        row[w] = value ? ~Word(0) : Word(0);
+      }
+      if (value && _width % word_bits) { // keep the padding bits clear
+        row[_wordsPerRow - 1] &= (Word(1) << (_width % word_bits)) - 1;
+      }
+    }
+  }
+
+  /// number of set cells, a word at a time
+  std::size_t count() const {
+    std::size_t result = 0;
+    for (Word w : _words) {
+      result += __builtin_popcountll(w);
+    }
+    return result;
+  }
+
+  /// number of set cells in the inclusive rectangle [lo, hi], clipped to the grid
+  std::size_t count(glm::ivec2 lo, glm::ivec2 hi) const {
+    std::size_t result = 0;
+    _forEachSpan(lo, hi, [&result](Word w) {
+      result += __builtin_popcountll(w);
+      return true;
+    });
+    return result;
+  }
+
+  /// whether every cell of the inclusive rectangle [lo, hi] is set; cells off the grid are not
+  bool all(glm::ivec2 lo, glm::ivec2 hi) const {
+    if (not inBounds(lo) || not inBounds(hi)) {
+      return false;
+    }
+    return count(lo, hi) == static_cast<std::size_t>(hi.x - lo.x + 1) * (hi.y - lo.y + 1);
+  }
+
+  /// whether any cell of the inclusive rectangle [lo, hi] is set
+  bool any(glm::ivec2 lo, glm::ivec2 hi) const {
+    bool found = false;
+    _forEachSpan(lo, hi, [&found](Word w) {
+      found = w != 0;
+      return not found;
+    });
+    return found;
+  }
+
+  /// x of the first set cell in row y at or after x, or -1 if there is none
+  int findNext(int x, int y) const {
+    if (y < 0 || y >= _height || x >= _width) {
+      return -1;
+    }
+    x = std::max(x, 0);
+
+    const Word* row = &_words[static_cast<std::size_t>(y) * _wordsPerRow];
+    int w = x / word_bits;
+    Word bits = row[w] & (~Word(0) << (x % word_bits));
+    while (bits == 0) {
+      if (++w == _wordsPerRow) {
+        return -1;
+      }
+      bits = row[w];
+    }
+    return w * word_bits + __builtin_ctzll(bits);
+  }
+
+  /// calls fn(glm::ivec2) for every set cell, skipping empty words
+  template <typename F>
+  void forEachSet(F&& fn) const {
+    for (int y = 0; y < _height; ++y) {
+      const Word* row = &_words[static_cast<std::size_t>(y) * _wordsPerRow];
+      for (int w = 0; w < _wordsPerRow; ++w) {
+        for (Word bits = row[w]; bits != 0; bits &= bits - 1) {
+          fn(glm::ivec2(w * word_bits + __builtin_ctzll(bits), y));
+        }
+      }
+    }
+  }
+
+  /// cellwise and/or with a grid of the same size
+  BitGrid& operator&=(const BitGrid& other) {
+    for (std::size_t i = 0; i < _words.size(); ++i) {
+      _words[i] &= other._words[i];
+    }
+    return *this;
+  }
+
+  BitGrid& operator|=(const BitGrid& other) {
+    for (std::size_t i = 0; i < _words.size(); ++i) {
+      _words[i] |= other._words[i];
+    }
+    return *this;
+  }
+
+private:
+  /// calls fn(Word) with the masked bits of each word overlapping the rectangle, until it
+  /// returns false
+  template <typename F>
+  void _forEachSpan(glm::ivec2 lo, glm::ivec2 hi, F&& fn) const {
+    lo = glm::max(lo, glm::ivec2(0, 0));
+    hi = glm::min(hi, glm::ivec2(_width - 1, _height - 1));
+    if (lo.x > hi.x || lo.y > hi.y) {
+      return;
+    }
+
+    const int firstWord = lo.x / word_bits, lastWord = hi.x / word_bits;
+    const Word firstMask = ~Word(0) << (lo.x % word_bits);
+    const Word lastMask = ~Word(0) >> (word_bits - 1 - hi.x % word_bits);
+    for (int y = lo.y; y <= hi.y; ++y) {
+      const Word* row = &_words[static_cast<std::size_t>(y) * _wordsPerRow];
+      for (int w = firstWord; w <= lastWord; ++w) {
+        Word bits = row[w];
+        if (w == firstWord) bits &= firstMask;
+        if (w == lastWord) bits &= lastMask;
+        if (not fn(bits)) {
+          return;
+        }
+      }
+    }
+  }
+
+  std::size_t _index(glm::ivec2 p) const {
+    return static_cast<std::size_t>(p.y) * _wordsPerRow + p.x / word_bits;
+  }
+};
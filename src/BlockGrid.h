@@ -0,0 +1,134 @@
+#pragma once
+
+#include <glm/common.hpp>
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief A width by height grid of T stored in small square blocks, for work on neighborhoods
+ * @detail Grid keeps cells row by row, so the cell above another is a whole row away and a
+ * search spreading in every direction touches a new cache line for most steps along y. Here
+ * the map is cut into block_side square blocks, each stored contiguously and the blocks row by
+ * row, so a cell's 8 neighbors are nearly always in the same block or the next one over. The
+ * interface matches Grid's, plus neighbor and rectangle visits that walk the blocks in storage
+ * order. Indexing isn't bounds checked.
+ */
+template <typename T, int BlockShift = 3>
+class BlockGrid {
+public:
+  static constexpr int block_shift = BlockShift;
+  static constexpr int block_side = 1 << block_shift; // cells along each side of a block
+
+private:
+  static constexpr int block_mask = block_side - 1;
+
+  int _width = 0;
+  int _height = 0;
+  int _blocksPerRow = 0;
+  std::vector<T> _cells;
+
+  std::size_t _index(glm::ivec2 p) const {
+    const std::size_t block =
+        static_cast<std::size_t>(p.y >> block_shift) * _blocksPerRow + (p.x >> block_shift);
+    return (block << (2 * block_shift)) + ((p.y & block_mask) << block_shift) +
+           (p.x & block_mask);
+  }
+
+  static std::size_t _cellCount(int width, int height) {
+    const std::size_t blocksPerRow = (width + block_mask) >> block_shift;
+    const std::size_t blockRows = (height + block_mask) >> block_shift;
+    return (blocksPerRow * blockRows) << (2 * block_shift);
+  }
+
+public:
+  BlockGrid() = default;
+  /// cells past the edge that fill out the last blocks take value too, but are never visited
+  BlockGrid(int width, int height, const T& value = T()) {
+    assign(width, height, value);
+  }
+
+  int width() const {
+    return _width;
+  }
+
+  int height() const {
+    return _height;
+  }
+
+  bool inBounds(glm::ivec2 p) const {
+    return p.x >= 0 && p.y >= 0 && p.x < _width && p.y < _height;
+  }
+
+  T& operator[](glm::ivec2 p) {
+    return _cells[_index(p)];
+  }
+
+  const T& operator[](glm::ivec2 p) const {
+    return _cells[_index(p)];
+  }
+
+  void fill(const T& value) {
+    std::fill(_cells.begin(), _cells.end(), value);
+  }
+
+  /// sets every cell in the inclusive rectangle [lo, hi] to value
+  void fill(glm::ivec2 lo, glm::ivec2 hi, const T& value) {
+    forEach(lo, hi, [&value](glm::ivec2, T& cell) { cell = value; });
+  }
+
+  /// resizes to width by height with every cell set to value, reusing the allocation if it fits
+  void assign(int width, int height, const T& value = T()) {
+    _width = width;
+    _height = height;
+    _blocksPerRow = (width + block_mask) >> block_shift;
+    _cells.assign(_cellCount(width, height), value);
+  }
+
+  /**
+   * @brief Calls fn(p, cell) for every cell in the inclusive rectangle [lo, hi] on the grid
+   * @detail A block at a time, in storage order, rather than row by row across the rectangle
+   */
+  template <typename F>
+  void forEach(glm::ivec2 lo, glm::ivec2 hi, F&& fn) {
+    lo = glm::max(lo, glm::ivec2(0, 0));
+    hi = glm::min(hi, glm::ivec2(_width - 1, _height - 1));
+    if (lo.x > hi.x || lo.y > hi.y) {
+      return;
+    }
+
+    for (int by = lo.y >> block_shift; by <= hi.y >> block_shift; ++by) {
+      for (int bx = lo.x >> block_shift; bx <= hi.x >> block_shift; ++bx) {
+        const glm::ivec2 first = glm::max(lo, glm::ivec2(bx, by) << block_shift);
+        const glm::ivec2 last = glm::min(hi, (glm::ivec2(bx, by) << block_shift) + block_mask);
+        for (int y = first.y; y <= last.y; ++y) {
+          T* cell = &_cells[_index({first.x, y})];
+          for (int x = first.x; x <= last.x; ++x) {
+            fn(glm::ivec2(x, y), *cell++);
+          }
+        }
+      }
+    }
+  }
+
+  /// calls fn(n, cell) for each of the up to 8 cells around p that are on the grid
+  template <typename F>
+  void forEachNeighbor(glm::ivec2 p, F&& fn) {
+    static const glm::ivec2 offsets[] = {{1, 0},  {-1, 0}, {0, 1},  {0, -1},
+                                         {1, 1},  {1, -1}, {-1, 1}, {-1, -1}};
+    for (const glm::ivec2& d : offsets) {
+      const glm::ivec2 n = p + d;
+      if (inBounds(n)) {
+        fn(n, _cells[_index(n)]);
+      }
+    }
+  }
+};
+
+template <typename T, int BlockShift>
+constexpr int BlockGrid<T, BlockShift>::block_shift;
+template <typename T, int BlockShift>
+constexpr int BlockGrid<T, BlockShift>::block_side;
+template <typename T, int BlockShift>
+constexpr int BlockGrid<T, BlockShift>::block_mask;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief A monotone priority queue over small integer keys (Dial's algorithm)
+ * @detail Keys live in a circular array of buckets starting at the current minimum key, so push
+ * and pop are O(1) amortized as long as keys never fall behind the last popped key. A key that
+ * does is clamped to the current minimum, and the ring doubles whenever a key lands beyond it.
+ *
+ * @tparam T The type of the values being queued
+ */
+template <typename T>
+class BucketQueue {
+  std::vector<std::vector<T>> _buckets;
+  std::size_t _cursor = 0; // the smallest key that can still be in the queue
+  std::size_t _size = 0;
+
+  std::size_t _mask() const {
+    return _buckets.size() - 1;
+  }
+
+  void _grow() {
+    std::vector<std::vector<T>> buckets(_buckets.size() * 2);
+    for (std::size_t i = 0; i < _buckets.size(); ++i) {
+      const std::size_t key = _cursor + ((i - _cursor) & _mask());
+      buckets[key & (buckets.size() - 1)] = std::move(_buckets[i]);
+    }
+    _buckets = std::move(buckets);
+  }
+
+public:
+  /// span is rounded up to a power of two and should cover the usual distance between keys
+  explicit BucketQueue(std::size_t span = 64) {
+    std::size_t size = 1;
+    while (size < span) {
+      size *= 2;
+    }
+    _buckets.resize(size);
+  }
+
+  bool empty() const {
+    return _size == 0;
+  }
+
+  std::size_t size() const {
+    return _size;
+  }
+
+  void push(std::size_t key, T value) {
+    if (key < _cursor) {
+      key = _cursor;
+    }
+    while (key - _cursor >= _buckets.size()) {
+      _grow();
+    }
+    _buckets[key & _mask()].push_back(std::move(value));
+    ++_size;
+  }
+
+  /// removes and returns a value with the smallest key; the queue must not be empty
+  T pop() {
+    while (_buckets[_cursor & _mask()].empty()) {
+      ++_cursor;
+    }
+    auto& bucket = _buckets[_cursor & _mask()];
+    T value = std::move(bucket.back());
+    bucket.pop_back();
+    --_size;
+    return value;
+  }
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Config.h"
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <deque>
+
+/**
+ * @brief The most recent rectangles of tiles to change, each stamped with a version
+ * @detail Every change bumps the version. Anything derived from the tiles keeps the version it
+ * was last up to date with and asks for what has changed since, so it can redo just those
+ * rectangles rather than everything. Only the last few changes are kept; one that has fallen
+ * further behind than that is told so and has to start over.
+ */
+class ChangeJournal {
+public:
+  struct Change {
+    glm::ivec2 lo, hi; // inclusive
+    std::uint64_t version;
+    bool opened; // may have made a tile walkable, or cheaper to cross
+    bool nav;    // may have changed where paths can go or what they cost, not just the look
+  };
+
+private:
+  std::deque<Change> _changes; // oldest first
+  std::size_t _capacity;
+  std::uint64_t _version = 0;
+
+public:
+  explicit ChangeJournal(std::size_t capacity = change_journal_length)
+      : _capacity(capacity > 0 ? capacity : 1) {}
+
+  /// the version after the latest change, 0 before any
+  std::uint64_t version() const {
+    return _version;
+  }
+
+  void record(glm::ivec2 lo, glm::ivec2 hi, bool opened, bool nav = true) {
+    _changes.push_back(Change{lo, hi, ++_version, opened, nav});
+    if (_changes.size() > _capacity) {
+      _changes.pop_front();
+    }
+  }
+
+  /// whether every change after version is still kept
+  bool covers(std::uint64_t version) const {
+    return version <= _version && _version - version <= _changes.size();
+  }
+
+  /**
+   * @brief Calls fn(change) for every change after version, oldest first
+   * @return false, calling nothing, if some of them are no longer kept
+   */
+  template <typename F>
+  bool forEachSince(std::uint64_t version, F&& fn) const {
+    if (not covers(version)) {
+      return false;
+    }
+    for (auto it = _changes.end() - static_cast<std::ptrdiff_t>(_version - version);
+         it != _changes.end(); ++it) {
+      fn(*it);
+    }
+    return true;
+  }
+};
@@ -0,0 +1,68 @@
+#include "ChunkFile.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+ChunkFile::ChunkFile(std::size_t slots, std::size_t slotBytes)
+    : _slotBytes(slotBytes), _bytes(slots * slotBytes) {
+  const char* dir = std::getenv("TMPDIR");
+  std::string path = std::string(dir ? dir : "/tmp") + "/fortress-chunks-XXXXXX";
+
+  _fd = mkstemp(&path[0]);
+  if (_fd < 0) {
+    throw std::runtime_error("ChunkFile: can't create " + path);
+  }
+  unlink(path.c_str());
+
+  if (ftruncate(_fd, static_cast<off_t>(_bytes)) != 0) {
+    _close();
+    throw std::runtime_error("ChunkFile: can't size the chunk file");
+  }
+
+  void* map = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+  if (map == MAP_FAILED) {
+    _close();
+    throw std::runtime_error("ChunkFile: can't map the chunk file");
+  }
+  _map = static_cast<unsigned char*>(map);
+}
+
+ChunkFile::ChunkFile(ChunkFile&& other) {
+  *this = std::move(other);
+}
+
+ChunkFile& ChunkFile::operator=(ChunkFile&& other) {
+  if (this != &other) {
+    _close();
+    std::swap(_fd, other._fd);
+    std::swap(_map, other._map);
+    std::swap(_slotBytes, other._slotBytes);
+    std::swap(_bytes, other._bytes);
+  }
+  return *this;
+}
+
+void ChunkFile::write(std::size_t slot, const void* data) {
+  std::memcpy(_map + slot * _slotBytes, data, _slotBytes);
+}
+
+void ChunkFile::read(std::size_t slot, void* data) const {
+  std::memcpy(data, _map + slot * _slotBytes, _slotBytes);
+}
+
+void ChunkFile::_close() {
+  if (_map) {
+    munmap(_map, _bytes);
+    _map = nullptr;
+  }
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief A scratch file of fixed-size slots, mapped into memory
+ * @detail Backs Region chunks that have been paged out. The file is created in the temp
+ * directory and unlinked straight away, so it goes when the process does. Slots are written and
+ * read with plain copies; the mapping is shared and file backed, so the kernel can write cold
+ * pages out and drop them rather than keep them in memory. The file is sparse, so slots that are
+ * never written take no disk space.
+ */
+class ChunkFile {
+  int _fd = -1;
+  unsigned char* _map = nullptr;
+  std::size_t _slotBytes = 0;
+  std::size_t _bytes = 0;
+
+  void _close();
+
+public:
+  ChunkFile() = default;
+  /// throws std::runtime_error if the file can't be created or mapped
+  ChunkFile(std::size_t slots, std::size_t slotBytes);
+  ~ChunkFile() {
+    _close();
+  }
+
+  ChunkFile(const ChunkFile&) = delete;
+  ChunkFile& operator=(const ChunkFile&) = delete;
+  ChunkFile(ChunkFile&& other);
+  ChunkFile& operator=(ChunkFile&& other);
+
+  bool isOpen() const {
+    return _map != nullptr;
+  }
+
+  void write(std::size_t slot, const void* data);
+  void read(std::size_t slot, void* data) const;
+};
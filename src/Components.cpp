@@ -1,10 +1,13 @@
 #include "Components.h"
-#include "Game.h"
+#include "ECS/Manager.h"
+#include "Sweep.h"
+#include "Tile.h"
 #include "Unit.h"
 #include "World.h"
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/projection.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <cmath>
 
 constexpr ECS::ComponentTypeId TransformComponent::type;
 constexpr ECS::ComponentTypeId SelectableComponent::type;
@@ -14,66 +17,62 @@ constexpr ECS::ComponentTypeId HealthComponent::type;
 constexpr ECS::ComponentTypeId AttackComponent::type;
 constexpr ECS::ComponentTypeId ResourceComponent::type;
 constexpr ECS::ComponentTypeId LightComponent::type;
+constexpr ECS::ComponentTypeId FactionComponent::type;
+constexpr ECS::ComponentTypeId StructureComponent::type;
 
-void TransformComponent::translate(glm::vec2 displacement) {
-  using V = glm::vec2;
-  constexpr float precision = 0.1; // in unit coordinates
-  Region& region = world.region();
-
-  V step = glm::normalize(displacement) * precision;
-  float steps = glm::length(displacement) / precision;
-
-  auto validPosition = [&](const glm::vec2& pos) {
-    if (pos.x < 0 || pos.y < 0 || pos.x >= world_size || pos.y > world_size) {
-      return false;
-    }
-    const glm::ivec2 tilePos = Game::mapCoordsToTile(pos);
-    return TileProperties::of(region.at(tilePos)).walkable &&
-           world.structureAt(tilePos) == nullptr;
-  };
+void createComponentStores() {
+  ECS::Manager::createComponentStore<TransformComponent>();
+  ECS::Manager::createComponentStore<MotionComponent>();
+  ECS::Manager::createComponentStore<SelectableComponent>();
+  ECS::Manager::createComponentStore<CommandableComponent>();
+  ECS::Manager::createComponentStore<HealthComponent>();
+  ECS::Manager::createComponentStore<AttackComponent>();
+  ECS::Manager::createComponentStore<ResourceComponent>();
+  ECS::Manager::createComponentStore<LightComponent>();
+  ECS::Manager::createComponentStore<FactionComponent>();
+  ECS::Manager::createComponentStore<StructureComponent>();
+}
 
-  auto intersectsTile = [&](const glm::vec2& pos, const glm::ivec2& tile) {
-    const float half_size = tile_size / 2.f;
-    auto clamp = [](float f, float lo, float hi) { return std::max(lo, std::min(f, hi)); };
-    glm::vec2 tileCenter = Game::centerOfTile(tile);
-    glm::vec2 nearest(clamp(pos.x, tileCenter.x - half_size, tileCenter.x + half_size),
-                      clamp(pos.y, tileCenter.y - half_size, tileCenter.y + half_size));
-    float dist = glm::distance(pos, nearest);
-    return dist < Unit::unit_size * 0.9f;
-  };
+void TransformComponent::translate(glm::vec2 displacement) {
+  constexpr float radius = Unit::body_radius;
+  constexpr int max_slides = 3; // a corner takes two, so a third is plenty
+  const Region& region = world.region();
+  const BitGrid& walkable = region.walkability();
 
-  auto stepPosition = [&](glm::vec2 step) {
-    const glm::vec2 newPos = pos + step;
-    const glm::ivec2 tile = Game::mapCoordsToTile(newPos);
-    const std::array<glm::ivec2, 8> neighbors{
-        glm::ivec2{tile.x - 1, tile.y},     glm::ivec2{tile.x + 1, tile.y},
-        glm::ivec2{tile.x, tile.y - 1},     glm::ivec2{tile.x, tile.y + 1},
-        glm::ivec2{tile.x + 1, tile.y + 1}, glm::ivec2{tile.x + 1, tile.y - 1},
-        glm::ivec2{tile.x - 1, tile.y + 1}, glm::ivec2{tile.x - 1, tile.y - 1}};
-    for (const glm::ivec2& t : neighbors) {
-      if (not validPosition(t) && intersectsTile(newPos, t)) {
-        glm::vec2 oppositeDir = newPos - Game::centerOfTile(t);
-        pos += glm::normalize(oppositeDir) * glm::length(step);
-        return false;
-      }
-    }
-    pos = newPos;
-    return true;
-  };
+  // something may have been built on top of us since the last move
+  pos = region.obstacleDistance().pushOut(pos, radius);
 
-  // big steps
-  while (steps >= 1) {
-    stepPosition(step);
-    steps -= 1;
+  for (int i = 0; i < max_slides && displacement != glm::vec2(0, 0); ++i) {
+    const Sweep sweep = sweepCircle(walkable, pos, displacement, radius);
+    pos = sweep.contact;
+    displacement = sweep.slide;
   }
+}
+
+float TransformComponent::renderRot(float alpha) const {
+  // turn the short way round
+  const float turn = std::remainder(rot - prevRot, glm::two_pi<float>());
+  return prevRot + turn * alpha;
+}
 
-  // final partial step
-  step *= steps;
-  stepPosition(step);
+float TransformComponent::terrainSpeed() const {
+  const TileType& tile = TileProperties::of(world.region().at(mapCoordsToTile(pos)));
+  return static_cast<float>(base_move_cost) / tile.moveCost;
 }
 
 void MotionComponent::pathTo(glm::vec2 pos) {
-  target = Game::centerOfTile(pos);
+  target = centerOfTile(pos);
   path.clear();
+  waypoint = 0;
   hasTarget = true;
 }
+
+void MotionComponent::follow(Path planned, glm::vec2 from) {
+  path = std::move(planned);
+  waypoint = 0;
+  hasTarget = not path.empty();
+  if (hasTarget) {
+    target = centerOfTile(path.back());
+    oldPosition = from;
+  }
+}
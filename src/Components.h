@@ -2,14 +2,17 @@
 
 #include "Config.h"
 #include "ECS/Component.h"
-#include "Graphics.h"
+#include "Faction.h"
 
 #include "Path.h"
 
-#include <deque>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
 #include <functional>
 
 class World;
+enum class StructureType;
 
 struct TransformComponent : public ECS::Component {
   World& world;
@@ -17,11 +20,31 @@ struct TransformComponent : public ECS::Component {
   glm::vec2 pos;
   float rot;
 
+  // pos and rot as of the previous simulation step, to draw in between
+  glm::vec2 prevPos;
+  float prevRot;
+
   static constexpr ECS::ComponentTypeId type = 1;
 
-  TransformComponent(World& world, glm::vec2 pos, float rot) : world(world), pos(pos), rot(rot) {}
+  TransformComponent(World& world, glm::vec2 pos, float rot)
+      : world(world), pos(pos), rot(rot), prevPos(pos), prevRot(rot) {}
 
   void translate(glm::vec2 displacement);
+
+  /// remembers the current pos and rot before a simulation step changes them
+  void snapshot() {
+    prevPos = pos;
+    prevRot = rot;
+  }
+
+  /// where to draw at alpha of the way from the previous step to the current one
+  glm::vec2 renderPos(float alpha) const {
+    return prevPos + (pos - prevPos) * alpha;
+  }
+  float renderRot(float alpha) const;
+
+  /// fraction of full speed a mover keeps on the tile it is standing on
+  float terrainSpeed() const;
 };
 
 struct SelectableComponent : public ECS::Component {
@@ -37,23 +60,34 @@ struct SelectableComponent : public ECS::Component {
 struct MotionComponent : public ECS::Component {
   float movementSpeed = 2.f; // TODO: not hardcoded
 
-  Path::iterator currentTarget; // when path.empty, this iterator is invalid
   glm::vec2 target{0, 0};
   bool hasTarget = false;
 
-  glm::vec2 oldPosition; // where it was before moving to current path waypoint
+  glm::vec2 oldPosition{0, 0}; // where it was before moving to current path waypoint
   Path path;
+  std::size_t waypoint = 0; // index into path of the waypoint being walked to
 
   static constexpr ECS::ComponentTypeId type = 3;
 
   MotionComponent() {}
 
   void pathTo(glm::vec2 pos);
+  /// follows an already planned path, leaving from `from`; repaths to its end if interrupted
+  void follow(Path planned, glm::vec2 from);
   void repath() {
     if (hasTarget) {
       pathTo(target);
     }
   }
+
+  /// whether there is a waypoint left to walk to
+  bool onPath() const {
+    return waypoint < path.size();
+  }
+
+  glm::ivec2 currentWaypoint() const {
+    return path[waypoint];
+  }
 };
 
 struct CommandableComponent : public ECS::Component {
@@ -112,3 +146,23 @@ struct LightComponent : public ECS::Component {
 
   LightComponent(glm::vec4 color, float intensity) : color(color), intensity(intensity) {}
 };
+
+/// which side an entity fights on, so Systems needn't guess from its other components
+struct FactionComponent : public ECS::Component {
+  Faction faction;
+
+  static constexpr ECS::ComponentTypeId type = 9;
+
+  FactionComponent(Faction faction) : faction(faction) {}
+};
+
+struct StructureComponent : public ECS::Component {
+  StructureType structureType;
+
+  static constexpr ECS::ComponentTypeId type = 10;
+
+  StructureComponent(StructureType structureType) : structureType(structureType) {}
+};
+
+/// registers a ComponentStore with ECS::Manager for every component above
+void createComponentStores();
@@ -6,9 +6,22 @@ using ResourceType = float;
 
 // many rendered things are used as k * tile_size, like unit_size, view_size
 constexpr float tile_size = 1.f;
-constexpr int world_size = 100;
+// tiles along each side of the map Game and fortress-sim start with; Region takes any size
+constexpr int default_world_size = 100;
+// Region chunks kept in memory before the least recently used are paged out to disk, 1KB each
+constexpr unsigned resident_chunk_budget = 1024;
+// findPath keeps its state in 8x8 tile blocks, 1KB each, and past this many lets go of those
+// the last search didn't reach
+constexpr unsigned path_scratch_block_budget = 1024;
+// Region edits remembered for anything catching up on them; one further behind starts over
+constexpr unsigned change_journal_length = 4096;
 
 constexpr ResourceType sell_ratio = 2;
 constexpr ResourceType init_resource_bal = 500;
 
 constexpr float muzzleFlashTime = 0.15f;
+
+// the simulation always advances by sim_step, however fast frames are drawn
+constexpr float sim_step = 1.f / 30;
+// after a stall, the simulation runs at most this many steps to catch up, then falls behind
+constexpr int max_sim_steps = 5;
@@ -0,0 +1,173 @@
+#include "Definitions.h"
+#include "Structure.h"
+#include "Tile.h"
+#include "UnitType.h"
+
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// clang-format off
+const char* const tile_names[] = {"NONE", "GRASS", "SAND", "WATER", "MOUNTAIN"};
+const char* const structure_names[] = {"NONE", "DEFAULT", "BASE", "WALL"};
+const char* const unit_names[] = {"UNIT", "ENEMY"};
+// clang-format on
+
+static_assert(sizeof(tile_names) / sizeof(*tile_names) == tile_count, "name every Tile");
+static_assert(sizeof(structure_names) / sizeof(*structure_names) == structure_type_count,
+              "name every StructureType");
+static_assert(sizeof(unit_names) / sizeof(*unit_names) == unit_type_count,
+              "name every UnitType");
+
+std::runtime_error error(int line, const std::string& what) {
+  return std::runtime_error("definitions line " + std::to_string(line) + ": " + what);
+}
+
+template <std::size_t N>
+std::size_t indexOf(const char* const (&names)[N], const std::string& name, int line) {
+  for (std::size_t i = 0; i < N; ++i) {
+    if (name == names[i]) {
+      return i;
+    }
+  }
+  throw error(line, "unknown name " + name);
+}
+
+template <typename T>
+T number(const std::string& value, int line) {
+  std::istringstream in(value);
+  T result;
+  if (not(in >> result) || not in.eof()) {
+    throw error(line, "bad number " + value);
+  }
+  return result;
+}
+
+void setField(TileType& type, const std::string& key, const std::string& value, int line) {
+  if (key == "walkable") {
+    type.walkable = number<int>(value, line) != 0;
+  } else if (key == "moveCost") {
+    type.moveCost = number<int>(value, line);
+    if (type.moveCost < 1) {
+      throw error(line, "moveCost must be at least 1");
+    }
+  } else if (key == "texOffset") {
+    type.texOffset = number<int>(value, line);
+  } else if (key == "color") {
+    std::istringstream in(value);
+    std::string channel;
+    for (int i = 0; i < 4; ++i) {
+      if (not std::getline(in, channel, ',')) {
+        throw error(line, "color needs 4 channels");
+      }
+      type.color[i] = number<float>(channel, line);
+    }
+  } else {
+    throw error(line, "tiles have no field " + key);
+  }
+}
+
+void setField(StructureData& data, const std::string& key, const std::string& value, int line) {
+  if (key == "health") {
+    data.health = number<HealthValue>(value, line);
+  } else if (key == "resourceSpeed") {
+    data.resourceSpeed = number<ResourceType>(value, line);
+  } else if (key == "cost") {
+    data.cost = number<ResourceType>(value, line);
+  } else if (key == "texOffset") {
+    data.texOffset = number<int>(value, line);
+  } else {
+    throw error(line, "structures have no field " + key);
+  }
+}
+
+void setField(UnitData& data, const std::string& key, const std::string& value, int line) {
+  if (key == "health") {
+    data.health = number<HealthValue>(value, line);
+  } else if (key == "strength") {
+    data.strength = number<StrengthValue>(value, line);
+  } else if (key == "attackRange") {
+    data.attackRange = number<float>(value, line);
+  } else if (key == "attackCooldown") {
+    data.attackCooldown = number<float>(value, line);
+  } else if (key == "cost") {
+    data.cost = number<ResourceType>(value, line);
+  } else {
+    throw error(line, "units have no field " + key);
+  }
+}
+
+/// applies the key=value fields left in in to entry
+template <typename Entry>
+void setFields(Entry& entry, std::istringstream& in, int line) {
+  std::string field;
+  while (in >> field) {
+    const std::size_t equals = field.find('=');
+    if (equals == std::string::npos) {
+      throw error(line, "expected key=value, not " + field);
+    }
+    setField(entry, field.substr(0, equals), field.substr(equals + 1), line);
+  }
+}
+
+} // namespace
+
+void loadDefinitions(std::istream& in) {
+  // work on copies, so a bad line leaves the tables as they were
+  std::array<TileType, tile_count> tiles;
+  for (std::size_t i = 0; i < tile_count; ++i) {
+    tiles[i] = TileProperties::of(static_cast<Tile>(i));
+  }
+  std::array<StructureData, structure_type_count> structures;
+  for (std::size_t i = 0; i < structure_type_count; ++i) {
+    structures[i] = StructureProperties::of(static_cast<StructureType>(i));
+  }
+  std::array<UnitData, unit_type_count> units;
+  for (std::size_t i = 0; i < unit_type_count; ++i) {
+    units[i] = UnitProperties::of(static_cast<UnitType>(i));
+  }
+
+  std::string text;
+  for (int line = 1; std::getline(in, text); ++line) {
+    std::istringstream fields(text.substr(0, text.find('#')));
+    std::string kind, name;
+    if (not(fields >> kind)) {
+      continue;
+    }
+    if (not(fields >> name)) {
+      throw error(line, kind + " needs a name");
+    }
+
+    if (kind == "tile") {
+      setFields(tiles[indexOf(tile_names, name, line)], fields, line);
+    } else if (kind == "structure") {
+      setFields(structures[indexOf(structure_names, name, line)], fields, line);
+    } else if (kind == "unit") {
+      setFields(units[indexOf(unit_names, name, line)], fields, line);
+    } else {
+      throw error(line, "unknown kind " + kind);
+    }
+  }
+
+  for (std::size_t i = 0; i < tile_count; ++i) {
+    TileProperties::set(static_cast<Tile>(i), tiles[i]);
+  }
+  for (std::size_t i = 0; i < structure_type_count; ++i) {
+    StructureProperties::set(static_cast<StructureType>(i), structures[i]);
+  }
+  for (std::size_t i = 0; i < unit_type_count; ++i) {
+    UnitProperties::set(static_cast<UnitType>(i), units[i]);
+  }
+}
+
+bool loadDefinitionsFile(const std::string& path) {
+  std::ifstream in(path);
+  if (not in) {
+    return false;
+  }
+  loadDefinitions(in);
+  return true;
+}
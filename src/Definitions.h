@@ -0,0 +1,24 @@
+#pragma once
+
+#include <istream>
+#include <string>
+
+/**
+ * @brief Reads tile, structure and unit definitions into TileProperties, StructureProperties and
+ * UnitProperties
+ * @detail One definition per line: its kind, the enum name it defines, then key=value fields,
+ * e.g.
+ *
+ *   tile SAND walkable=1 moveCost=3 texOffset=3 color=0.6,0.6,0.4,1
+ *   structure WALL health=500 resourceSpeed=0 cost=25 texOffset=7
+ *   unit ENEMY health=100 strength=25 attackRange=1.5 attackCooldown=1 cost=0
+ *
+ * Fields left out keep their current values, so a file only needs what it changes. Blank lines
+ * and everything after a # are skipped. Nothing is changed unless the whole input parses.
+ *
+ * @throws std::runtime_error naming the line of anything it can't use
+ */
+void loadDefinitions(std::istream& in);
+
+/// loadDefinitions from a file; returns false, changing nothing, if it can't be opened
+bool loadDefinitionsFile(const std::string& path);
@@ -0,0 +1,178 @@
+#include "DistanceField.h"
+#include "Config.h"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr float far = std::numeric_limits<float>::max();
+
+const glm::ivec2 neighbors[] = {{1, 0},  {-1, 0}, {0, 1},  {0, -1},
+                                {1, 1},  {1, -1}, {-1, 1}, {-1, -1}};
+
+/// from the center of tile to the nearest edge of obstacle
+float tileToObstacle(glm::ivec2 tile, glm::ivec2 obstacle) {
+  const glm::vec2 gap = glm::max(glm::abs(glm::vec2(tile - obstacle)) - 0.5f, 0.f);
+  return glm::length(gap) * tile_size;
+}
+
+} // namespace
+
+void DistanceField::rebuild(const BitGrid& walkable) {
+  _width = walkable.width();
+  _height = walkable.height();
+  _nearest.assign(static_cast<std::size_t>(_width) * _height, glm::ivec2(0, 0));
+  _distance.assign(_nearest.size(), far);
+
+  _wave.clear();
+  for (int y = 0; y < _height; ++y) {
+    for (int x = 0; x < _width; ++x) {
+      const glm::ivec2 p(x, y);
+      if (not walkable.get(p)) {
+        _nearest[_index(p)] = p;
+        _distance[_index(p)] = 0;
+        _wave.push_back(static_cast<int>(_index(p)));
+      } else if (x == 0 || y == 0 || x == _width - 1 || y == _height - 1) {
+        _seedBorder(p);
+      }
+    }
+  }
+  _lower();
+}
+
+void DistanceField::update(const BitGrid& walkable, glm::ivec2 lo, glm::ivec2 hi) {
+  if (walkable.width() != _width || walkable.height() != _height) {
+    rebuild(walkable);
+    return;
+  }
+  lo = glm::max(lo, glm::ivec2(0, 0));
+  hi = glm::min(hi, glm::ivec2(_width - 1, _height - 1));
+  if (lo.x > hi.x || lo.y > hi.y) {
+    return;
+  }
+
+  auto inArea = [&](glm::ivec2 p) {
+    return p.x >= lo.x && p.y >= lo.y && p.x <= hi.x && p.y <= hi.y;
+  };
+
+  // obstacles in the area lower the field around them; everything else there is cleared
+  _wave.clear();
+  std::vector<int> cleared;
+  for (int y = lo.y; y <= hi.y; ++y) {
+    for (int x = lo.x; x <= hi.x; ++x) {
+      const glm::ivec2 p(x, y);
+      const int i = static_cast<int>(_index(p));
+      if (not walkable.get(p)) {
+        _nearest[i] = p;
+        _distance[i] = 0;
+        _wave.push_back(i);
+      } else {
+        _distance[i] = far;
+        cleared.push_back(i);
+      }
+    }
+  }
+
+  // clear every tile that was nearest to an obstacle the area lost, and collect the tiles
+  // around them that still know their nearest obstacle to refill them from
+  for (std::size_t head = 0; head < cleared.size(); ++head) {
+    const glm::ivec2 p(cleared[head] % _width, cleared[head] / _width);
+    for (const glm::ivec2& d : neighbors) {
+      const glm::ivec2 n = p + d;
+      if (not _inBounds(n)) {
+        continue;
+      }
+      const int j = static_cast<int>(_index(n));
+      if (_distance[j] < far && inArea(_nearest[j]) && walkable.get(_nearest[j])) {
+        _distance[j] = far;
+        cleared.push_back(j);
+      } else if (_distance[j] < far) {
+        _wave.push_back(j);
+      }
+    }
+  }
+  for (int j : cleared) {
+    _seedBorder({j % _width, j / _width});
+  }
+  _lower();
+}
+
+float DistanceField::tileDistance(glm::ivec2 tile) const {
+  return _inBounds(tile) ? _distance[_index(tile)] : 0.f;
+}
+
+glm::ivec2 DistanceField::nearestObstacle(glm::ivec2 tile) const {
+  return _inBounds(tile) ? _nearest[_index(tile)] : tile;
+}
+
+DistanceField::Sample DistanceField::sample(glm::vec2 pos) const {
+  if (_width == 0 || _height == 0) {
+    return Sample{far, glm::vec2(0, 0)};
+  }
+
+  const glm::ivec2 tile = glm::clamp(glm::ivec2(glm::floor(pos / tile_size)), glm::ivec2(0),
+                                     glm::ivec2(_width - 1, _height - 1));
+  const glm::vec2 lo = glm::vec2(_nearest[_index(tile)]) * tile_size, hi = lo + tile_size;
+
+  const glm::vec2 away = pos - glm::clamp(pos, lo, hi);
+  const float distance = glm::length(away);
+  if (distance > 0) {
+    return Sample{distance, away / distance};
+  }
+
+  // inside the obstacle, so the way out is through its nearest side
+  const float exits[] = {pos.x - lo.x, hi.x - pos.x, pos.y - lo.y, hi.y - pos.y};
+  const glm::vec2 sides[] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+  const int side = std::min_element(exits, exits + 4) - exits;
+  return Sample{-exits[side], sides[side]};
+}
+
+glm::vec2 DistanceField::pushOut(glm::vec2 pos, float radius) const {
+  // usually one sample; a second obstacle in a corner may take another
+  for (int i = 0; i < 4; ++i) {
+    const Sample s = sample(pos);
+    if (s.distance >= radius) {
+      break;
+    }
+    pos += s.normal * (radius - s.distance);
+  }
+  return pos;
+}
+
+void DistanceField::_seedBorder(glm::ivec2 p) {
+  const glm::ivec2 outside[] = {{-1, p.y}, {_width, p.y}, {p.x, -1}, {p.x, _height}};
+  for (const glm::ivec2& o : outside) {
+    const float d = tileToObstacle(p, o);
+    if (d < _distance[_index(p)]) {
+      _nearest[_index(p)] = o;
+      _distance[_index(p)] = d;
+      _wave.push_back(static_cast<int>(_index(p)));
+    }
+  }
+}
+
+void DistanceField::_lower() {
+  for (std::size_t head = 0; head < _wave.size(); ++head) {
+    const int i = _wave[head];
+    const glm::ivec2 p(i % _width, i / _width);
+    const glm::ivec2 obstacle = _nearest[i];
+    for (const glm::ivec2& d : neighbors) {
+      const glm::ivec2 n = p + d;
+      if (not _inBounds(n)) {
+        continue;
+      }
+      const std::size_t j = _index(n);
+      const float distance = tileToObstacle(n, obstacle);
+      if (distance < _distance[j]) {
+        _distance[j] = distance;
+        _nearest[j] = obstacle;
+        _wave.push_back(static_cast<int>(j));
+      }
+    }
+  }
+  _wave.clear();
+}
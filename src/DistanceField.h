@@ -0,0 +1,65 @@
+#pragma once
+
+#include "BitGrid.h"
+
+#include <glm/vec2.hpp>
+
+#include <vector>
+
+/**
+ * @brief For every tile, the nearest unwalkable tile and how far away it is
+ * @detail Built by a brushfire wave out from every blocked tile, where each tile takes on its
+ * neighbor's nearest obstacle whenever that is closer than its own. Tiles off the grid count as
+ * obstacles. Changing a tile, or a rectangle of them, only redoes the area it affects: new
+ * obstacles send a lowering wave out from themselves, and removed ones first clear every tile
+ * that pointed at them, then refill those from around the cleared area.
+ */
+class DistanceField {
+  int _width = 0;
+  int _height = 0;
+  std::vector<glm::ivec2> _nearest; // may lie just off the grid
+  std::vector<float> _distance;     // from the tile's center to its nearest obstacle's edge
+
+  std::vector<int> _wave; // reused between updates
+
+  std::size_t _index(glm::ivec2 p) const {
+    return static_cast<std::size_t>(p.y) * _width + p.x;
+  }
+
+  bool _inBounds(glm::ivec2 p) const {
+    return p.x >= 0 && p.y >= 0 && p.x < _width && p.y < _height;
+  }
+
+  void _seedBorder(glm::ivec2 p);
+  void _lower();
+
+public:
+  struct Sample {
+    float distance;   // from the point to the nearest obstacle's edge; negative inside it
+    glm::vec2 normal; // unit vector pointing away from that obstacle
+  };
+
+  DistanceField() = default;
+  explicit DistanceField(const BitGrid& walkable) {
+    rebuild(walkable);
+  }
+
+  void rebuild(const BitGrid& walkable);
+  /// updates the field after walkable changed at cell
+  void update(const BitGrid& walkable, glm::ivec2 cell) {
+    update(walkable, cell, cell);
+  }
+
+  /// updates the field after walkable changed anywhere in the inclusive rectangle [lo, hi]
+  void update(const BitGrid& walkable, glm::ivec2 lo, glm::ivec2 hi);
+
+  /// distance from the center of tile to the nearest obstacle's edge; 0 on obstacles
+  float tileDistance(glm::ivec2 tile) const;
+  glm::ivec2 nearestObstacle(glm::ivec2 tile) const;
+
+  /// the obstacle nearest to the tile under pos, measured from pos itself
+  Sample sample(glm::vec2 pos) const;
+
+  /// moves a circle at pos out of any obstacle it overlaps
+  glm::vec2 pushOut(glm::vec2 pos, float radius) const;
+};
@@ -99,6 +99,16 @@ public:
     return _store.at(entity);
   }
 
+  /**
+   * @brief Iterators over every Entity-Component pair in the store
+   */
+  typename EntityToComponentMap::iterator begin() {
+    return _store.begin();
+  }
+  typename EntityToComponentMap::iterator end() {
+    return _store.end();
+  }
+
   /**
    * @brief Keep a copy of the instance of C associated with the Entity,
    * then remove the Entity-Component pair from the internal store
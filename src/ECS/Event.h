@@ -17,8 +17,7 @@ class BaseEventSubscriber;
 
 using TypeIndex = std::type_index;
 
-using SubscribersMap =
-    std::unordered_map<TypeIndex, std::vector<std::shared_ptr<BaseEventSubscriber>>>;
+using SubscribersMap = std::unordered_map<TypeIndex, std::vector<BaseEventSubscriber*>>;
 
 using EventQueue = std::vector<std::function<void()>>;
 
@@ -83,6 +82,7 @@ class EventManager {
 
   /**
    * @brief Connects the subsciber to the channel of Events being handled by the EventManager
+   * @detail The subscriber stays owned by the caller, and must disconnect before it is destroyed.
    *
    * @tparam Event The type of events the subscriber receives
    * @param subscriber The instance of EventSubscriber with the Event template parameter
@@ -93,12 +93,12 @@ class EventManager {
     auto it = _subscribers.find(index);
 
     if (it == _subscribers.end()) {
-      std::vector<std::shared_ptr<BaseEventSubscriber>> subList;
-      subList.push_back(std::shared_ptr<BaseEventSubscriber>(subscriber));
+      std::vector<BaseEventSubscriber*> subList;
+      subList.push_back(subscriber);
 
       _subscribers.insert({index, subList});
     } else {
-      it->second.push_back(std::shared_ptr<BaseEventSubscriber>(subscriber));
+      it->second.push_back(subscriber);
     }
   }
 
@@ -115,7 +115,7 @@ class EventManager {
 
     if (it != _subscribers.end()) {
       auto secondIndex = it->second.begin();
-      while (secondIndex != it->second.end() && secondIndex->get() != subscriber) {
+      while (secondIndex != it->second.end() && *secondIndex != subscriber) {
         ++secondIndex;
       }
       if (secondIndex != it->second.end()) {
@@ -153,7 +153,7 @@ class EventManager {
     if (it != _subscribers.end()) {
       auto subscribers = it->second;
       for (auto base : subscribers) {
-        auto sub = reinterpret_cast<EventSubscriber<Event>*>(base.get());
+        auto sub = static_cast<EventSubscriber<Event>*>(base);
 
         auto boundFunc = std::bind(&EventSubscriber<Event>::receive, sub, *event);
         _events.push_back(std::function<void()>(boundFunc));
@@ -16,6 +16,17 @@ void Manager::_addSystem(const System::Ptr& systemPtr) {
   _systems.push_back(systemPtr);
 }
 
+bool Manager::_removeSystem(const System* system) {
+  auto it = std::find_if(_systems.begin(), _systems.end(),
+                         [system](const System::Ptr& s) { return s.get() == system; });
+  if (it == _systems.end()) {
+    return false;
+  }
+
+  _systems.erase(it);
+  return true;
+}
+
 std::size_t Manager::_registerEntity(const Entity entity) {
   std::size_t associatedSystems = 0;
 
@@ -61,6 +72,16 @@ std::size_t Manager::_unregisterEntity(const Entity entity) {
   return associatedSystems;
 }
 
+std::size_t Manager::_wake(const Entity entity) {
+  std::size_t wokenSystems = 0;
+
+  for (auto& system : _systems) {
+    wokenSystems += system->wake(entity);
+  }
+
+  return wokenSystems;
+}
+
 std::size_t Manager::_update(float dt) {
   std::size_t updatedSystems = 0;
 
@@ -75,12 +96,25 @@ std::size_t Manager::_update(float dt) {
     _unregisterEntity(id);
     _entities.erase(id);
   }
+  _deleteSet.clear();
 
   return updatedSystems;
 }
 
+void Manager::_render(float alpha) {
+  for (auto& system : _systems) {
+    system->render(alpha);
+  }
+}
+
 bool Manager::_clear() {
+  for (auto& system : _systems) {
+    for (const auto& entity : _entities) {
+      system->unregisterEntity(entity.first);
+    }
+  }
   _entities.clear();
+  _deleteSet.clear();
 
   return _entities.size() == 0;
 }
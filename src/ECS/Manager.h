@@ -110,6 +110,15 @@ class Manager {
    */
   void _addSystem(const System::Ptr& systemPtr);
 
+  /**
+   * @brief Removes the given system from the SystemContainer, if it is there
+   *
+   * @param system The system to remove
+   *
+   * @return Whether the system was found
+   */
+  bool _removeSystem(const System* system);
+
   /**
    * @brief Creates an Entity
    *
@@ -191,6 +200,15 @@ class Manager {
    */
   std::size_t _unregisterEntity(const Entity entity);
 
+  /**
+   * @brief Wakes the provided Entity in every System where it sleeps
+   *
+   * @param entity The Entity to wake
+   *
+   * @return The number of systems in which entity was woken
+   */
+  std::size_t _wake(const Entity entity);
+
   /**
    * @brief Update each System contained in the SystemContainer
    *
@@ -201,7 +219,14 @@ class Manager {
   std::size_t _update(float dt);
 
   /**
-   * @brief Clears every Entity from the Manager
+   * @brief Render each System contained in the SystemContainer
+   *
+   * @param alpha How far the frame is from the previous update to the latest one
+   */
+  void _render(float alpha);
+
+  /**
+   * @brief Clears every Entity from the Manager, unregistering each from its Systems
    *
    * @return Success in clearing the underlying data structure
    */
@@ -236,6 +261,9 @@ public:
   static void addSystem(const System::Ptr& systemPtr) {
     return _getInstance()._addSystem(systemPtr);
   }
+  static bool removeSystem(const System* system) {
+    return _getInstance()._removeSystem(system);
+  }
   static Entity createEntity() {
     return _getInstance()._createEntity();
   }
@@ -245,9 +273,15 @@ public:
   static std::size_t unregisterEntity(const Entity entity) {
     return _getInstance()._unregisterEntity(entity);
   }
+  static std::size_t wake(const Entity entity) {
+    return _getInstance()._wake(entity);
+  }
   static std::size_t update(float dt) {
     return _getInstance()._update(dt);
   }
+  static void render(float alpha) {
+    _getInstance()._render(alpha);
+  }
   static bool deleteEntity(Entity id) {
     return _getInstance()._deleteEntity(id);
   }
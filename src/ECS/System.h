@@ -6,6 +6,8 @@
 #include <iostream>
 #include <memory>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "Component.h"
 #include "Entity.h"
@@ -25,10 +27,72 @@ class System {
   ComponentTypeSet _requiredComponents;
 
   /**
-   * @brief The set of entities that are being managed by this System
+   * @brief The set of awake entities that are being managed by this System
    */
   EntitySet _matchingEntities;
 
+  /**
+   * @brief Entities managed by this System that are skipped by `update` until woken
+   */
+  EntitySet _sleepingEntities;
+
+  /**
+   * @brief Entities that asked to sleep; they're moved out of the awake set between updates
+   */
+  EntitySet _drowsyEntities;
+
+  /**
+   * @brief How many updates apart each Entity is visited, see `setUpdateInterval`
+   */
+  unsigned _interval = 1;
+
+  std::size_t _frame = 0;
+  std::vector<float> _recentDts; // the last _interval values of dt, oldest first overwritten
+  // the _frame each Entity registered or woke at, until its first visit after that
+  std::unordered_map<Entity, std::size_t> _joinedAt;
+
+  /// marks the Entity as new, so its first visit only counts the time since now
+  void _join(Entity entity) {
+    if (_interval > 1) {
+      _joinedAt[entity] = _frame;
+    }
+  }
+
+  std::size_t _updateStaggered() {
+    float elapsed = 0;
+    for (float recent : _recentDts) {
+      elapsed += recent;
+    }
+
+    std::size_t updatedEntities = 0;
+    for (auto entity = _matchingEntities.begin(); entity != _matchingEntities.end(); ++entity) {
+      if ((*entity + _frame) % _interval == 0) {
+        auto joined = _joinedAt.empty() ? _joinedAt.end() : _joinedAt.find(*entity);
+        if (joined == _joinedAt.end()) {
+          updateEntity(elapsed, *entity);
+        } else {
+          float since = 0;
+          for (std::size_t frame = joined->second + 1; frame <= _frame; ++frame) {
+            since += _recentDts[frame % _interval];
+          }
+          _joinedAt.erase(joined);
+          updateEntity(since, *entity);
+        }
+        ++updatedEntities;
+      }
+    }
+    return updatedEntities;
+  }
+
+  void _settle() {
+    for (Entity entity : _drowsyEntities) {
+      if (_matchingEntities.erase(entity)) {
+        _sleepingEntities.insert(entity);
+      }
+    }
+    _drowsyEntities.clear();
+  }
+
 protected:
   GameState& _gameState;
 
@@ -58,6 +122,19 @@ protected:
     _requiredComponents = std::move(requiredComponents);
   }
 
+  /**
+   * @brief Visits each Entity only once every few updates
+   * @detail Entities are spread over the frames by their id, so each update visits about
+   * 1/frames of them, and `updateEntity` gets the time since that Entity's last visit as dt. On
+   * the first visit after registering or waking, that's only the time since then.
+   *
+   * @param frames How many updates apart each Entity is visited
+   */
+  void setUpdateInterval(unsigned frames) {
+    _interval = std::max(frames, 1u);
+    _recentDts.assign(_interval, 0.f);
+  }
+
 public:
   using Ptr = std::shared_ptr<System>;
 
@@ -81,7 +158,11 @@ public:
    * @return Success in inserting the Entity
    */
   virtual bool registerEntity(Entity entity) {
-    return _matchingEntities.insert(entity).second;
+    if (_sleepingEntities.count(entity) || not _matchingEntities.insert(entity).second) {
+      return false;
+    }
+    _join(entity);
+    return true;
   }
 
   /**
@@ -91,8 +172,10 @@ public:
    *
    * @return Success in removing the Entity
    */
-  std::size_t unregisterEntity(Entity entity) {
-    return _matchingEntities.erase(entity);
+  virtual std::size_t unregisterEntity(Entity entity) {
+    _drowsyEntities.erase(entity);
+    _joinedAt.erase(entity);
+    return _matchingEntities.erase(entity) + _sleepingEntities.erase(entity);
   }
 
   /**
@@ -103,14 +186,58 @@ public:
    * @return Presence of the Entity in the EntitySet
    */
   bool hasEntity(Entity entity) const {
+    return _matchingEntities.find(entity) != _matchingEntities.end() ||
+           _sleepingEntities.find(entity) != _sleepingEntities.end();
+  }
+
+  /**
+   * @brief Stops updating the Entity until something wakes it
+   * @detail Takes effect once the current update is over, so it is safe to call from
+   * `updateEntity`. A System should only put an Entity to sleep when it knows which event will
+   * need it again, and make sure that event calls `Manager::wake`.
+   *
+   * @param entity The Entity to put to sleep
+   */
+  void sleep(Entity entity) {
+    if (_matchingEntities.count(entity)) {
+      _drowsyEntities.insert(entity);
+    }
+  }
+
+  /**
+   * @brief Resumes updating a sleeping Entity, or keeps an awake one from falling asleep
+   *
+   * @param entity The Entity to wake
+   *
+   * @return Whether the Entity was asleep or about to be
+   */
+  bool wake(Entity entity) {
+    const bool wasDrowsy = _drowsyEntities.erase(entity);
+    if (_sleepingEntities.erase(entity)) {
+      _matchingEntities.insert(entity);
+      _join(entity); // the time asleep isn't owed to it
+      return true;
+    }
+    return wasDrowsy;
+  }
+
+  /**
+   * @brief Tells whether the Entity is updated by this System
+   *
+   * @param entity The Entity to check for
+   *
+   * @return Presence of the Entity among the awake entities
+   */
+  bool isAwake(Entity entity) const {
     return _matchingEntities.find(entity) != _matchingEntities.end();
   }
 
   /**
    * @brief Updates the system
-   * @detail Calls `updateEntity(dt, entity)` on every Entity in this System's EntitySet.
+   * @detail Calls `updateEntity(dt, entity)` on every awake Entity in this System's EntitySet.
    * This can be overridden in derived Systems to update other parts of the System, but
    * the override should be implemented in a refinement-style approach, rather than replacement.
+   * Systems with an update interval only visit some of their Entities each time.
    *
    * @param dt The amount of time that has passed since the last call (in seconds)
    *
@@ -118,18 +245,36 @@ public:
    */
   virtual std::size_t update(float dt) {
     std::size_t updatedEntities = 0;
+    _settle(); // anything put to sleep since the last update
 
-    // TODO: we crash here when an entity gets killed.
-    // entity (the iterator itself) gets corrupted, incremented, and dereferenced
-    for (auto entity = _matchingEntities.begin(); entity != _matchingEntities.end(); ++entity) {
-      updateEntity(dt, *entity); // each user class should specialize this
-                                 // pure virtual function
-      ++updatedEntities;
+    ++_frame;
+    if (_interval > 1) {
+      _recentDts[_frame % _interval] = dt;
+      updatedEntities = _updateStaggered();
+    } else {
+      // TODO: we crash here when an entity gets killed.
+      // entity (the iterator itself) gets corrupted, incremented, and dereferenced
+      for (auto entity = _matchingEntities.begin(); entity != _matchingEntities.end(); ++entity) {
+        updateEntity(dt, *entity); // each user class should specialize this
+                                   // pure virtual function
+        ++updatedEntities;
+      }
     }
+    _settle();
 
     return updatedEntities;
   }
 
+  /**
+   * @brief Draws the System's Entities
+   * @detail Called once for every frame drawn, however many fixed-length updates ran before it.
+   * Positions should be blended between the last two updates with alpha, so motion looks smooth
+   * at any frame rate. Drawing belongs here rather than in `update`.
+   *
+   * @param alpha How far the frame is from the previous update to the latest one, from 0 to 1
+   */
+  virtual void render(float alpha) {}
+
   /**
    * @brief Derived Systems should update the System for a specific Entity
    * @detail When creating a System implementation, it is necessary for the user
@@ -141,12 +286,21 @@ public:
   virtual void updateEntity(float dt, Entity entity) = 0;
 
   /**
-   * @brief Gets the set of Entities this System is managing
+   * @brief Gets the set of awake Entities this System is managing
    *
-   * @return The set of Entities this System is managing
+   * @return The set of awake Entities this System is managing
    */
   const EntitySet& entities() {
     return _matchingEntities;
   }
+
+  /**
+   * @brief Gets the set of sleeping Entities this System is managing
+   *
+   * @return The set of sleeping Entities this System is managing
+   */
+  const EntitySet& sleepingEntities() const {
+    return _sleepingEntities;
+  }
 };
 } // namespace ECS
@@ -1,5 +1,5 @@
 #include "Enemy.h"
-#include "Game.h"
+#include "Tile.h"
 
 #include "Path.h"
 #include "World.h"
@@ -7,9 +7,11 @@
 Enemy::Enemy(glm::vec2 pos, World& world) : _target(pos), id(ECS::Manager::createEntity()) {
   ECS::Manager::addComponent<TransformComponent>(id, TransformComponent(world, pos, 0.f));
   ECS::Manager::addComponent<MotionComponent>(id, MotionComponent());
-  ECS::Manager::addComponent<HealthComponent>(id, HealthComponent(max_health));
-  ECS::Manager::addComponent<AttackComponent>(id,
-                                              AttackComponent(strength, radius, attackCooldown));
+  const UnitData& data = UnitProperties::of(UnitType::ENEMY);
+  ECS::Manager::addComponent<HealthComponent>(id, HealthComponent(data.health));
+  ECS::Manager::addComponent<AttackComponent>(
+      id, AttackComponent(data.strength, data.attackRange, data.attackCooldown));
+  ECS::Manager::addComponent<FactionComponent>(id, FactionComponent(Faction::ENEMY));
 
   ECS::Manager::registerEntity(id);
 }
@@ -22,12 +24,17 @@ Path& Enemy::path() const {
   return ECS::Manager::getComponent<MotionComponent>(id).path;
 }
 
+std::size_t Enemy::waypoint() const {
+  return ECS::Manager::getComponent<MotionComponent>(id).waypoint;
+}
+
 glm::ivec2 Enemy::currentTarget() const {
-  return ECS::Manager::getComponent<MotionComponent>(id).currentTarget.operator*();
+  return ECS::Manager::getComponent<MotionComponent>(id).currentWaypoint();
 }
 
 void Enemy::pathTo(glm::vec2 v) {
   ECS::Manager::getComponent<MotionComponent>(id).pathTo(v);
+  ECS::Manager::wake(id);
 }
 
 void Enemy::repath() const {
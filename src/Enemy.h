@@ -5,8 +5,8 @@
 #include "Components.h"
 
 #include "Config.h"
-#include "Graphics.h"
 #include "Path.h"
+#include "UnitType.h"
 
 class World;
 
@@ -19,10 +19,6 @@ public:
 
   constexpr static float unit_size = 0.5f * tile_size;
   constexpr static float unit_speed = 2.f;
-  constexpr static HealthValue max_health = 100;
-  constexpr static StrengthValue strength = 25;
-  constexpr static float attackCooldown = 1.f;
-  constexpr static float radius = 1.5f;
 
   Enemy(glm::vec2 pos, World&);
   constexpr Enemy(const Enemy&) = default;
@@ -36,6 +32,7 @@ public:
   glm::vec2 pos() const;
   bool selected() const;
   Path& path() const;
+  std::size_t waypoint() const;
   glm::ivec2 currentTarget() const;
   void pathTo(glm::vec2 v);
   void repath() const;
@@ -10,7 +10,6 @@
 #include <random>
 
 class EnemySpawner {
-  constexpr static float world_bounds = world_size * tile_size;
   constexpr static float spawn_interval = 5;      // seconds
   constexpr static int spawn_group_count = 1;     // number of groups
   constexpr static int spawn_group_size = 3;      // max enemies per group
@@ -22,11 +21,15 @@ class EnemySpawner {
   float _timer = spawn_interval;
 
   std::uniform_int_distribution<int> _sideDist{0, 3};
-  std::uniform_real_distribution<float> _fdist{tile_size / 2.f, world_bounds - tile_size / 2.f};
   std::uniform_real_distribution<float> _angleDist{0, glm::pi<float>() * 2};
 
+  float _worldBounds() const {
+    return _world.size() * tile_size;
+  }
+
   float _pos() {
-    return _fdist(_mt);
+    return std::uniform_real_distribution<float>(tile_size / 2.f,
+                                                 _worldBounds() - tile_size / 2.f)(_mt);
   }
   int _side() {
     return _sideDist(_mt);
@@ -39,6 +42,7 @@ class EnemySpawner {
 
 public: // seed with random device
   EnemySpawner(World& world) : _mt((std::random_device{})()), _world(world) {}
+  EnemySpawner(World& world, unsigned seed) : _mt(seed), _world(world) {}
 
   void update(float dt) {
     _timer -= dt;
@@ -49,6 +53,7 @@ public: // seed with random device
   }
 
   void spawn() {
+    const float worldBounds = _worldBounds();
     for (int i = 0; i < spawn_group_count; ++i) {
       int side = _side();
 
@@ -60,16 +65,16 @@ public: // seed with random device
         pos = {_pos(), tile_size / 2.f + spawn_tiles_from_edge};
       }
       else if (side == 2) {
-        pos = {world_bounds - (tile_size / 2.f + spawn_tiles_from_edge), _pos()};
+        pos = {worldBounds - (tile_size / 2.f + spawn_tiles_from_edge), _pos()};
       }
       else {
-        pos = {_pos(), world_bounds - (tile_size / 2.f + spawn_tiles_from_edge)};
+        pos = {_pos(), worldBounds - (tile_size / 2.f + spawn_tiles_from_edge)};
       }
 
       for (int j = 0; j < spawn_group_size; ++j) {
         auto offsetPos = pos + _spawnOffset();
-        if (offsetPos.x < 0 || offsetPos.y < 0 || offsetPos.x >= world_bounds ||
-            offsetPos.y >= world_bounds) {
+        if (offsetPos.x < 0 || offsetPos.y < 0 || offsetPos.x >= worldBounds ||
+            offsetPos.y >= worldBounds) {
           continue;
         }
         _world.addEnemy(offsetPos);
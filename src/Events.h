@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ECS/Event.h"
+#include "Graphics/RenderWindow.h" // for GLFW's key actions
 
 struct MouseMoveEvent {
   MouseMoveEvent(float x, float y) : x(x), y(y) {}
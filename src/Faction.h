@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Which side an entity fights on
+ * @detail Each faction is a bit, so queries can take a mask of several at once, e.g.
+ * Faction::UNIT | Faction::STRUCTURE for everything an enemy may attack.
+ */
+enum class Faction : std::uint8_t { NONE = 0, UNIT = 1 << 0, ENEMY = 1 << 1, STRUCTURE = 1 << 2 };
+
+constexpr Faction operator|(Faction a, Faction b) {
+  return static_cast<Faction>(static_cast<std::uint8_t>(a) | static_cast<std::uint8_t>(b));
+}
+
+/// whether faction f is in mask
+constexpr bool inMask(Faction mask, Faction f) {
+  return (static_cast<std::uint8_t>(mask) & static_cast<std::uint8_t>(f)) != 0;
+}
+
+constexpr std::size_t faction_count = 3;
+
+/// 0, 1 or 2 for a single faction, to index per-faction arrays with
+constexpr std::size_t factionIndex(Faction f) {
+  return f == Faction::UNIT ? 0 : f == Faction::ENEMY ? 1 : 2;
+}
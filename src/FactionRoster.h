@@ -0,0 +1,66 @@
+#pragma once
+
+#include "ECS/Entity.h"
+#include "Faction.h"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Every unit, enemy and structure, in one dense array per Faction
+ * @detail Anything that works on one side, like drawing it or repathing it, walks exactly that
+ * side's array with no gaps and nothing else mixed in. Removing an entity moves the last one of
+ * its faction into its place, so it takes constant time but doesn't keep the order.
+ */
+class FactionRoster {
+  struct Slot {
+    Faction faction;
+    std::size_t index;
+  };
+
+  std::array<std::vector<ECS::Entity>, faction_count> _members;
+  std::unordered_map<ECS::Entity, Slot> _slots;
+
+public:
+  /// faction must be a single one; returns false if entity is already on the roster
+  bool add(ECS::Entity entity, Faction faction) {
+    std::vector<ECS::Entity>& members = _members[factionIndex(faction)];
+    if (not _slots.insert({entity, Slot{faction, members.size()}}).second) {
+      return false;
+    }
+    members.push_back(entity);
+    return true;
+  }
+
+  bool remove(ECS::Entity entity) {
+    auto it = _slots.find(entity);
+    if (it == _slots.end()) {
+      return false;
+    }
+
+    std::vector<ECS::Entity>& members = _members[factionIndex(it->second.faction)];
+    const std::size_t index = it->second.index;
+    if (index + 1 != members.size()) {
+      members[index] = members.back();
+      _slots[members[index]].index = index;
+    }
+    members.pop_back();
+    _slots.erase(it);
+    return true;
+  }
+
+  /// Faction::NONE if entity isn't on the roster
+  Faction factionOf(ECS::Entity entity) const {
+    auto it = _slots.find(entity);
+    return it == _slots.end() ? Faction::NONE : it->second.faction;
+  }
+
+  const std::vector<ECS::Entity>& members(Faction faction) const {
+    return _members[factionIndex(faction)];
+  }
+
+  std::size_t size() const {
+    return _slots.size();
+  }
+};
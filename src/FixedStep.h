@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Config.h"
+
+#include <cmath>
+
+/**
+ * @brief Turns the real time between frames into a whole number of sim_step updates
+ * @detail Time short of a whole step carries over to the next frame, and alpha() says how far
+ * into the next step it reaches, so frames can be drawn in between. A frame so slow that
+ * catching up would take more than max_sim_steps drops the rest instead, so one slow frame
+ * doesn't make the next one slower still.
+ */
+class FixedStep {
+  float _lag = 0; // simulation time the frames have gotten ahead by
+
+public:
+  /// adds dt seconds of real time, and returns how many steps to run for it
+  int advance(float dt) {
+    _lag += dt;
+    int steps = 0;
+    for (; _lag >= sim_step && steps < max_sim_steps; ++steps) {
+      _lag -= sim_step;
+    }
+    if (steps == max_sim_steps) {
+      _lag = std::fmod(_lag, sim_step); // too far behind to catch up, so let it go
+    }
+    return steps;
+  }
+
+  /// how far the time not simulated yet reaches into the next step, from 0 to 1
+  float alpha() const {
+    return _lag / sim_step;
+  }
+};
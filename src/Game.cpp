@@ -1,5 +1,6 @@
 #include "Game.h"
 #include "Config.h"
+#include "FixedStep.h"
 #include "Graphics.h"
 
 #include "ECS/Manager.h"
@@ -21,8 +22,14 @@ float Game::tile_view_size_target = Game::tile_view_size;
 
 Game::Game()
     : _resources(init_resource_bal), _window("Fortress Commander"),
-      _gameState(_window, _world._units, _world._enemies, _world._structures, _resources, _debug),
-      _world(world_size, _resources), _spawner(_world) {
+      _bulletParticles(_view, BulletParticle::beforeUpdate, BulletParticle::afterUpdate),
+      _deathParticles(_view, DeathParticle::beforeUpdate, DeathParticle::afterUpdate),
+      _gameState(_world, _resources, _debug),
+      _world(default_world_size, _resources), _spawner(_world) {
+  _view.center(_world.size() / 2.f, _world.size() / 2.f)
+      .radius(tile_view_size * tile_size / 2.f * _window.widthScalingFactor(),
+              tile_view_size * tile_size / 2.f);
+
   _window.setKeyCallback([this](auto&&... args) { this->keyCallback(args...); });
   _window.setMouseCallback([this](auto&&... args) { this->mouseCallback(args...); });
   _window.setCursorCallback([this](auto&&... args) { this->cursorCallback(args...); });
@@ -30,22 +37,15 @@ Game::Game()
 
   glfwSwapInterval(0); // oh, it's on by default
 
-  ECS::Manager::createComponentStore<TransformComponent>();
-  ECS::Manager::createComponentStore<MotionComponent>();
-  ECS::Manager::createComponentStore<SelectableComponent>();
-  ECS::Manager::createComponentStore<CommandableComponent>();
-  ECS::Manager::createComponentStore<HealthComponent>();
-  ECS::Manager::createComponentStore<AttackComponent>();
-  ECS::Manager::createComponentStore<ResourceComponent>();
-  ECS::Manager::createComponentStore<LightComponent>();
+  createComponentStores();
 
-  _lightRenderingSystem = new LightRenderingSystem(_gameState);
+  _lightRenderingSystem = new LightRenderingSystem(_gameState, _view, _window);
   ECS::Manager::addSystem(ECS::System::Ptr(_lightRenderingSystem));
 
   _moveSystem = new MoveSystem(_gameState);
   ECS::Manager::addSystem(ECS::System::Ptr(_moveSystem));
 
-  _unitSelectSystem = new UnitSelectSystem(_gameState);
+  _unitSelectSystem = new UnitSelectSystem(_gameState, _view);
   ECS::Manager::addSystem(ECS::System::Ptr(_unitSelectSystem));
 
   _unitCommandSystem = new UnitCommandSystem(_gameState);
@@ -54,20 +54,28 @@ Game::Game()
   _unitCollisionSystem = new UnitCollisionSystem(_gameState);
   ECS::Manager::addSystem(ECS::System::Ptr(_unitCollisionSystem));
 
+  _spatialIndexSystem = new SpatialIndexSystem(_gameState);
+  ECS::Manager::addSystem(ECS::System::Ptr(_spatialIndexSystem));
+
+  _targetingSystem = new TargetingSystem(_gameState);
+  ECS::Manager::addSystem(ECS::System::Ptr(_targetingSystem));
+
   _battleSystem = new BattleSystem(_gameState);
   ECS::Manager::addSystem(ECS::System::Ptr(_battleSystem));
 
   _resourceSystem = new ResourceSystem(_gameState, _world._resources);
   ECS::Manager::addSystem(ECS::System::Ptr(_resourceSystem));
 
-  _healthBarSystem = new HealthBarSystem(_gameState);
+  _healthBarSystem = new HealthBarSystem(_gameState, _view);
   ECS::Manager::addSystem(ECS::System::Ptr(_healthBarSystem));
 
   ECS::EventManager::connect<KeyDownEvent>(this);
   ECS::EventManager::connect<MouseDownEvent>(this);
   ECS::EventManager::connect<MouseMoveEvent>(this);
+  ECS::EventManager::connect<ShotEvent>(this);
+  ECS::EventManager::connect<DeathEvent>(this);
 
-  _world.addStructure({world_size / 2, world_size / 2 + 1}, StructureType::BASE);
+  _world.addStructure(_world.centerCell() + glm::ivec2(0, 1), StructureType::BASE);
 }
 
 template <typename T>
@@ -84,15 +92,25 @@ void Game::restart() {
 
   _spawner.reset();
 
-  _world = World(world_size, _resources);
+  _world = World(_world.size(), _resources);
+}
+
+void Game::_step() {
+  for (auto& entry : ECS::Manager::getComponentStore<TransformComponent>()) {
+    entry.second.snapshot();
+  }
+
+  ECS::Manager::update(sim_step);
+  _spawner.update(sim_step);
 }
 
 void Game::loop() {
   float last_time = glfwGetTime();
+  FixedStep clock;
   TextRenderer t(_window.defaultView());
 
   TextureBatch batch(ResourceManager::texture());
-  batch.view(_gameState._view);
+  batch.view(_view);
 
   while (_window.isOpen()) {
     glfwPollEvents();
@@ -112,15 +130,23 @@ void Game::loop() {
 
     if (_gameState._mode != ControlMode::PAUSE) {
       handleTick(dt);
-      _world.draw(batch, _gameState._view, _debug);
+
+      for (int steps = clock.advance(dt); steps > 0; --steps) {
+        _step();
+      }
+    }
+
+    const float alpha = clock.alpha();
+
+    if (_gameState._mode != ControlMode::PAUSE) {
+      _world.draw(batch, _view, _debug, alpha);
     }
 
-    ECS::Manager::update(dt);
+    ECS::Manager::render(alpha);
 
     if (_gameState._mode != ControlMode::PAUSE) {
-      _gameState._bulletParticles.update(dt);
-      _gameState._deathParticles.update(dt);
-      _spawner.update(dt);
+      _bulletParticles.update(dt);
+      _deathParticles.update(dt);
     }
 
     _drawUI(t, dt);
@@ -193,6 +219,16 @@ void Game::_drawUI(TextRenderer& t, float dt) {
       .position({75, 30})
       .size({150, 60})
       .color({.3, .3, .3, 1});
+
+    ui.add()
+      .position({250, 115})
+      .size({515, 75})
+      .color({.1, .1, .1, 1});
+
+    ui.add()
+      .position({250, 115})
+      .size({500, 60})
+      .color({.3, .3, .3, 1});
   }
   // clang-format on
 
@@ -205,7 +241,7 @@ void Game::_drawUI(TextRenderer& t, float dt) {
 
   if (_mode == ControlMode::BUILD) {
     modeStr = "BUILD";
-    _world.structHolo(_gameState._view, getMouseTile());
+    _world.structHolo(_view, getMouseTile());
 
     std::string buildStr = "STRUCTURE";
     if (_structureType == StructureType::WALL) {
@@ -216,20 +252,25 @@ void Game::_drawUI(TextRenderer& t, float dt) {
   }
   if (_mode == ControlMode::SELL) {
     modeStr = "SELL";
-    _world.structHolo(_gameState._view, getMouseTile());
+    _world.structHolo(_view, getMouseTile());
   }
   if (_mode == ControlMode::TERRAIN) {
     modeStr = "TERRAIN";
-    World::tileHolo(_gameState._view, getMouseTile());
+    World::tileHolo(_view, getMouseTile());
   }
   if (_mode == ControlMode::UNIT) {
     modeStr = "UNIT";
-    Unit::holo(_gameState._view, getMouseCoords());
+    Unit::holo(_view, getMouseCoords());
   }
   t.renderText(modeStr, _window.width() - 275, 50, 1, modeColor);
 
   if (_debug) {
     t.renderText(str(static_cast<int>(1.f / dt)), 25, 50, 1, glm::vec4(0, 0, 0, 1));
+
+    // path cache hits / splices / misses
+    const auto& paths = _world.pathCache().stats();
+    t.renderText("PATHS " + str(paths.hits) + "/" + str(paths.splices) + "/" + str(paths.misses),
+                 25, 135, 1, glm::vec4(0, 0, 0, 1));
   }
 
   t.renderText("RESOURCES: " + str(static_cast<int>(_resources)), _window.width() - 500,
@@ -311,6 +352,14 @@ void Game::receive(const MouseMoveEvent& e) {
 
 void Game::receive(const MouseScrollEvent& e) {}
 
+void Game::receive(const ShotEvent& e) {
+  _bulletParticles.add(BulletParticle(e.from, e.to, 20));
+}
+
+void Game::receive(const DeathEvent& e) {
+  _deathParticles.add(DeathParticle(e.pos));
+}
+
 void Game::keyCallback(int key, int scancode, int action, int mods) {
   if (action == GLFW_PRESS) {
     ECS::EventManager::event(new KeyDownEvent(key));
@@ -358,6 +407,6 @@ void Game::updateZoom(float dt) {
   tile_view_size = tile_view_size * (1 - current_rate) + tile_view_size_target * current_rate;
   tile_view_size_target = std::max(10.f, std::min(100.f, tile_view_size_target));
   // tile_view_size = tile_view_size_target;
-  _gameState._view.radius(tile_view_size * tile_size / 2.f * _window.widthScalingFactor(),
+  _view.radius(tile_view_size * tile_size / 2.f * _window.widthScalingFactor(),
                           tile_view_size * tile_size / 2.f);
 }
@@ -7,18 +7,26 @@
 #include "ECS/Event.h"
 #include "ECS/Manager.h"
 
+#include "BattleEvents.h"
 #include "Components.h"
 #include "EnemySpawner.h"
+#include "ParticleSystem.h"
 #include "Systems.h"
 #include "World.h"
 
 class Game : public ECS::EventSubscriber<KeyDownEvent>,
              ECS::EventSubscriber<MouseDownEvent>,
              ECS::EventSubscriber<MouseMoveEvent>,
-             ECS::EventSubscriber<MouseScrollEvent> {
+             ECS::EventSubscriber<MouseScrollEvent>,
+             ECS::EventSubscriber<ShotEvent>,
+             ECS::EventSubscriber<DeathEvent> {
   ResourceType _resources;
 
   RenderWindow _window;
+  View _view;
+  ParticleSystem<BulletParticle> _bulletParticles;
+  ParticleSystem<DeathParticle> _deathParticles;
+
   GameState _gameState;
   World _world;
   Tile _paint = Tile::GRASS;
@@ -29,7 +37,9 @@ class Game : public ECS::EventSubscriber<KeyDownEvent>,
   UnitSelectSystem* _unitSelectSystem;
   UnitCommandSystem* _unitCommandSystem;
   UnitCollisionSystem* _unitCollisionSystem;
+  SpatialIndexSystem* _spatialIndexSystem;
   MoveSystem* _moveSystem;
+  TargetingSystem* _targetingSystem;
   BattleSystem* _battleSystem;
   ResourceSystem* _resourceSystem;
   HealthBarSystem* _healthBarSystem;
@@ -38,7 +48,6 @@ class Game : public ECS::EventSubscriber<KeyDownEvent>,
   StructureType _structureType = StructureType::DEFAULT;
 
   void _mouseViewMove(float d) {
-    auto& _view = _gameState._view;
     constexpr int margin = 20;
     auto pos = _window.mousePos();
     // clang-format off
@@ -51,7 +60,6 @@ class Game : public ECS::EventSubscriber<KeyDownEvent>,
   }
 
   void _keyboardViewMove(float d) {
-    auto& _view = _gameState._view;
 
     // clang-format off
     if (_window.getKey(GLFW_KEY_W) == GLFW_PRESS) { _view.move(0, -d); }
@@ -62,13 +70,12 @@ class Game : public ECS::EventSubscriber<KeyDownEvent>,
   }
 
   void _reboundViewToWorld() {
-    auto& _view = _gameState._view;
 
     auto topLeft = _view.center() - _view.radius();
     auto bottomRight = _view.center() + _view.radius();
 
-    const auto viewRadius = world_size * tile_view_size / 2.f;
-    const auto worldBorder = world_size * tile_size;
+    const auto viewRadius = _world.size() * tile_view_size / 2.f;
+    const auto worldBorder = _world.size() * tile_size;
     const auto kw = _window.widthScalingFactor();
 
     if (topLeft.x < 0) {
@@ -85,6 +92,13 @@ class Game : public ECS::EventSubscriber<KeyDownEvent>,
     }
   }
 
+  /**
+   * @brief Advances the simulation by one sim_step
+   * @detail Remembers every transform first, so frames drawn before the next step can blend
+   * from where things were to where they are now.
+   */
+  void _step();
+
   /**
    * @brief Performs all UI-related draw calls
    *
@@ -104,7 +118,6 @@ public:
   }
 
   glm::vec2 pixelToCoords(glm::vec2 p) {
-    auto& _view = _gameState._view;
 
     // coords = V' W v
     // W : window -> opengl
@@ -112,19 +125,6 @@ public:
     return _view.inv() * _window.defaultView().proj() * glm::vec4(p.x, p.y, 0, 1);
   }
 
-  static glm::ivec2 mapCoordsToTile(glm::vec2 coords) {
-    return glm::ivec2(static_cast<int>(coords.x / tile_size),
-                      static_cast<int>(coords.y / tile_size));
-  }
-
-  static glm::vec2 centerOfTile(glm::vec2 p) {
-    return glm::floor(p) + glm::vec2(0.5 * tile_size, 0.5 * tile_size);
-  }
-
-  static glm::vec2 centerOfTile(glm::ivec2 p) {
-    return glm::vec2(p.x, p.y) + glm::vec2(0.5 * tile_size, 0.5 * tile_size);
-  }
-
   glm::vec<2, int> getMouseTile() {
     return mapCoordsToTile(getMouseCoords());
   }
@@ -136,6 +136,8 @@ public:
   void receive(const MouseDownEvent& e) override;
   void receive(const MouseMoveEvent& e) override;
   void receive(const MouseScrollEvent& e) override;
+  void receive(const ShotEvent& e) override;
+  void receive(const DeathEvent& e) override;
 
   void keyCallback(int key, int scancode, int action, int mods);
   void mouseCallback(int button, int action, int mods);
@@ -1,35 +1,35 @@
 #pragma once
 
-#include "Graphics.h"
+#include "Config.h"
 
-#include "Enemy.h"
-#include "ParticleSystem.h"
-#include "Structure.h"
+#include <memory>
 
 enum class ControlMode { NONE, PAUSE, BUILD, SELL, UNIT, TERRAIN };
 
-class Unit;
-class Enemy;
+class World;
+class FactionRosterSystem;
 
 /**
  * @brief Encapsulates state shared between Game and its Systems
+ * @detail Holds nothing graphical, so the simulation Systems run without a window; Systems that
+ * draw are handed the View they need on construction. While it lives, the ECS keeps its World's
+ * FactionRoster.
  */
 struct GameState {
-  RenderWindow& _window;
   ControlMode _mode = ControlMode::PAUSE;
-  View _view;
 
-  std::vector<Unit>& units;
-  std::vector<Enemy>& enemies;
-  std::vector<Structure>& structures;
-
-  ParticleSystem<BulletParticle> _bulletParticles;
-  ParticleSystem<DeathParticle> _deathParticles;
+  World& world;
 
   ResourceType& _resources;
 
   bool& debug;
 
-  GameState(RenderWindow& window, std::vector<Unit>& units, std::vector<Enemy>& enemies,
-            std::vector<Structure>& structures, ResourceType& resources, bool& debug);
+  GameState(World& world, ResourceType& resources, bool& debug);
+  ~GameState();
+
+  GameState(const GameState&) = delete;
+  void operator=(const GameState&) = delete;
+
+private:
+  std::shared_ptr<FactionRosterSystem> _rosterSystem;
 };
@@ -1,6 +1,59 @@
 #pragma once
-#include "Config.h"
-#include <array>
 
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief A width by height grid of T in one heap allocation
+ * @detail Sized at runtime, so it can match whatever Region it shadows. Cells are stored row by
+ * row, so neighbors along x are adjacent in memory. Indexing isn't bounds checked.
+ */
 template <typename T = unsigned char>
-using Grid = std::array<std::array<T, world_size>, world_size>;
\ No newline at end of file
+class Grid {
+  int _width = 0;
+  int _height = 0;
+  std::vector<T> _cells;
+
+  std::size_t _index(glm::ivec2 p) const {
+    return static_cast<std::size_t>(p.y) * _width + p.x;
+  }
+
+public:
+  Grid() = default;
+  Grid(int width, int height, const T& value = T())
+      : _width(width), _height(height),
+        _cells(static_cast<std::size_t>(width) * height, value) {}
+
+  int width() const {
+    return _width;
+  }
+
+  int height() const {
+    return _height;
+  }
+
+  bool inBounds(glm::ivec2 p) const {
+    return p.x >= 0 && p.y >= 0 && p.x < _width && p.y < _height;
+  }
+
+  T& operator[](glm::ivec2 p) {
+    return _cells[_index(p)];
+  }
+
+  const T& operator[](glm::ivec2 p) const {
+    return _cells[_index(p)];
+  }
+
+  void fill(const T& value) {
+    std::fill(_cells.begin(), _cells.end(), value);
+  }
+
+  /// resizes to width by height with every cell set to value, reusing the allocation if it fits
+  void assign(int width, int height, const T& value = T()) {
+    _width = width;
+    _height = height;
+    _cells.assign(static_cast<std::size_t>(width) * height, value);
+  }
+};
@@ -0,0 +1,148 @@
+#include "GroupMove.h"
+#include "BitGrid.h"
+#include "Tile.h"
+#include "LineOfSight.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+/// the n walkable cells nearest to goal in flood fill order, so each of them can reach it
+std::vector<glm::ivec2> formationSlots(const BitGrid& walkable, glm::ivec2 goal, std::size_t n) {
+  std::vector<glm::ivec2> slots;
+  if (not walkable.get(goal)) {
+    return slots;
+  }
+
+  static const glm::ivec2 neighbors[] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+  BitGrid seen(walkable.width(), walkable.height());
+  std::deque<glm::ivec2> frontier{goal};
+  seen.set(goal, true);
+  while (not frontier.empty() && slots.size() < n) {
+    const glm::ivec2 p = frontier.front();
+    frontier.pop_front();
+    slots.push_back(p);
+
+    for (const glm::ivec2& d : neighbors) {
+      const glm::ivec2 q = p + d;
+      if (walkable.get(q) && not seen.get(q)) {
+        seen.set(q, true);
+        frontier.push_back(q);
+      }
+    }
+  }
+  return slots;
+}
+
+} // namespace
+
+std::vector<Path> planGroupMove(Region& region, PathCache& cache,
+                                const std::vector<glm::vec2>& movers, glm::vec2 target,
+                                float clearance) {
+  std::vector<Path> result(movers.size());
+  if (movers.empty()) {
+    return result;
+  }
+
+  const BitGrid& walkable = region.walkability();
+  auto sees = [&](glm::vec2 a, glm::ivec2 b) -> bool {
+    return lineOfSight(walkable, a, centerOfTile(b), clearance);
+  };
+
+  glm::vec2 centroid(0, 0);
+  for (glm::vec2 p : movers) {
+    centroid += p;
+  }
+  centroid /= static_cast<float>(movers.size());
+
+  // the group starts under its centroid, or at whoever is closest to it if that is blocked
+  glm::ivec2 start = mapCoordsToTile(centroid);
+  if (not walkable.get(start)) {
+    float nearest = std::numeric_limits<float>::max();
+    for (glm::vec2 p : movers) {
+      if (glm::distance(p, centroid) < nearest) {
+        nearest = glm::distance(p, centroid);
+        start = mapCoordsToTile(p);
+      }
+    }
+  }
+
+  const glm::ivec2 goal = mapCoordsToTile(target);
+  const Path groupPath = cache.find(region, start, goal, clearance);
+  if (groupPath.empty() && start != goal) {
+    return result;
+  }
+  Path route{start};
+  route.append(groupPath.begin(), groupPath.end());
+
+  // movers nearest the middle of the formation pick first, each taking the free slot closest to
+  // where it stood relative to the centroid
+  const std::vector<glm::ivec2> slots = formationSlots(walkable, goal, movers.size());
+  std::vector<std::size_t> order(movers.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+    return glm::distance(movers[a], centroid) < glm::distance(movers[b], centroid);
+  });
+
+  std::vector<bool> taken(slots.size(), false);
+  std::vector<glm::ivec2> slotOf(movers.size(), goal);
+  for (std::size_t i : order) {
+    const glm::vec2 wanted = centerOfTile(goal) + (movers[i] - centroid);
+    std::size_t best = slots.size();
+    float bestDistance = std::numeric_limits<float>::max();
+    for (std::size_t s = 0; s < slots.size(); ++s) {
+      const float d = glm::distance(wanted, centerOfTile(slots[s]));
+      if (not taken[s] && d < bestDistance) {
+        bestDistance = d;
+        best = s;
+      }
+    }
+    if (best < slots.size()) {
+      taken[best] = true;
+      slotOf[i] = slots[best];
+    }
+  }
+
+  for (std::size_t i = 0; i < movers.size(); ++i) {
+    const glm::vec2 pos = movers[i];
+    const glm::ivec2 cell = mapCoordsToTile(pos);
+    Path& path = result[i];
+
+    // join the group path at the furthest waypoint in sight, or search to its start
+    std::size_t join = route.size();
+    while (join > 0 && not sees(pos, route[join - 1])) {
+      --join;
+    }
+    if (join > 0) {
+      const std::size_t from = route[join - 1] == cell ? join : join - 1;
+      path.assign(route.begin() + from, route.end());
+    } else {
+      path = cache.find(region, cell, start, clearance);
+      if (path.empty()) {
+        continue;
+      }
+      path.append(route.begin() + 1, route.end());
+    }
+
+    // then leave it for the formation slot
+    const glm::ivec2 slot = slotOf[i];
+    if (slot == goal) {
+      continue;
+    }
+    const glm::vec2 before = path.size() > 1 ? centerOfTile(path[path.size() - 2]) : pos;
+    if (not path.empty() && sees(before, slot)) {
+      path.back() = slot;
+    } else if (sees(centerOfTile(goal), slot)) {
+      path.push_back(slot);
+    } else {
+      const Path rest = cache.find(region, goal, slot, clearance);
+      path.append(rest.begin(), rest.end());
+    }
+  }
+
+  return result;
+}
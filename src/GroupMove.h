@@ -0,0 +1,26 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <vector>
+
+#include "Path.h"
+#include "PathCache.h"
+#include "Region.h"
+
+/**
+ * @brief Plans a move order for a whole selection with one shared search
+ * @detail The group path runs from the cell under the selection's centroid to the target. Every
+ * mover gets a formation slot, which is a walkable cell connected to the target, picked to keep
+ * roughly the same arrangement the selection had. A mover joins the group path at the furthest
+ * waypoint it can see and leaves it for its slot at the end. Only a mover that can't see the
+ * group path at all needs its own search, and that search only goes to the path's start.
+ *
+ * @param movers The current position of each mover
+ * @param clearance The body radius that has to fit along every straight leg
+ *
+ * @return One path per mover, in the same order as movers; empty where there is no way there
+ */
+std::vector<Path> planGroupMove(Region& region, PathCache& cache,
+                                const std::vector<glm::vec2>& movers, glm::vec2 target,
+                                float clearance = 0.f);
@@ -0,0 +1,158 @@
+#include "Kinematics.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// odd polynomial for atan on [0, 1], Abramowitz & Stegun 4.4.49
+constexpr float atan_c1 = 0.9998660f;
+constexpr float atan_c3 = -0.3302995f;
+constexpr float atan_c5 = 0.1801410f;
+constexpr float atan_c7 = -0.0851330f;
+constexpr float atan_c9 = 0.0208351f;
+
+/// TransformComponent::rot for a mover facing along (dx, dy)
+float headingOf(float dx, float dy) {
+  return -fastAtan2(dy, dx) - glm::half_pi<float>();
+}
+
+void steerScalar(Kinematics& k, std::size_t begin, float arriveRadius, float dt) {
+  for (std::size_t i = begin; i < k.size(); ++i) {
+    const float dx = k.targetX[i] - k.x[i], dy = k.targetY[i] - k.y[i];
+    const float legX = k.targetX[i] - k.fromX[i], legY = k.targetY[i] - k.fromY[i];
+    const float distance2 = dx * dx + dy * dy;
+
+    if (distance2 < arriveRadius * arriveRadius || legX * dx + legY * dy < 0) {
+      k.arrived[i] = ~std::uint32_t(0);
+      k.vx[i] = k.vy[i] = 0;
+      continue;
+    }
+
+    const float step = k.speed[i] * dt / std::sqrt(distance2);
+    k.arrived[i] = 0;
+    k.vx[i] = dx * step;
+    k.vy[i] = dy * step;
+    k.heading[i] = headingOf(dx, dy);
+  }
+}
+
+#ifdef __SSE2__
+
+__m128 atan2Sse(__m128 y, __m128 x) {
+  const __m128 sign = _mm_set1_ps(-0.f);
+  const __m128 ax = _mm_andnot_ps(sign, x), ay = _mm_andnot_ps(sign, y);
+  const __m128 hi = _mm_max_ps(ax, ay), lo = _mm_min_ps(ax, ay);
+
+  // a = lo / hi, or 0 where both are 0
+  const __m128 nonzero = _mm_cmpgt_ps(hi, _mm_setzero_ps());
+  const __m128 divisor = _mm_or_ps(hi, _mm_andnot_ps(nonzero, _mm_set1_ps(1)));
+  const __m128 a = _mm_and_ps(nonzero, _mm_div_ps(lo, divisor));
+  const __m128 s = _mm_mul_ps(a, a);
+
+  __m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(atan_c9), s), _mm_set1_ps(atan_c7));
+  r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c5));
+  r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c3));
+  r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(atan_c1));
+  r = _mm_mul_ps(r, a);
+
+  // unfold the octant: swap axes, then mirror for negative x, then take y's sign
+  const __m128 swapped = _mm_cmpgt_ps(ay, ax);
+  r = _mm_or_ps(_mm_and_ps(swapped, _mm_sub_ps(_mm_set1_ps(glm::half_pi<float>()), r)),
+                _mm_andnot_ps(swapped, r));
+  const __m128 negativeX = _mm_cmplt_ps(x, _mm_setzero_ps());
+  r = _mm_or_ps(_mm_and_ps(negativeX, _mm_sub_ps(_mm_set1_ps(glm::pi<float>()), r)),
+                _mm_andnot_ps(negativeX, r));
+  return _mm_or_ps(r, _mm_and_ps(sign, y));
+}
+
+/// the movers in [0, size rounded down to 4); returns where the scalar loop should pick up
+std::size_t steerSse(Kinematics& k, float arriveRadius, float dt) {
+  const std::size_t end = k.size() & ~std::size_t(3);
+  const __m128 radius2 = _mm_set1_ps(arriveRadius * arriveRadius);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 dtv = _mm_set1_ps(dt);
+  const __m128 quarterTurn = _mm_set1_ps(glm::half_pi<float>());
+
+  for (std::size_t i = 0; i < end; i += 4) {
+    const __m128 x = _mm_loadu_ps(&k.x[i]), y = _mm_loadu_ps(&k.y[i]);
+    const __m128 tx = _mm_loadu_ps(&k.targetX[i]), ty = _mm_loadu_ps(&k.targetY[i]);
+    const __m128 dx = _mm_sub_ps(tx, x), dy = _mm_sub_ps(ty, y);
+    const __m128 legX = _mm_sub_ps(tx, _mm_loadu_ps(&k.fromX[i]));
+    const __m128 legY = _mm_sub_ps(ty, _mm_loadu_ps(&k.fromY[i]));
+
+    const __m128 distance2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    const __m128 along = _mm_add_ps(_mm_mul_ps(legX, dx), _mm_mul_ps(legY, dy));
+    const __m128 arrived =
+        _mm_or_ps(_mm_cmplt_ps(distance2, radius2), _mm_cmplt_ps(along, zero));
+
+    // arrived lanes may divide by zero, but they are masked off below
+    const __m128 reach = _mm_mul_ps(_mm_loadu_ps(&k.speed[i]), dtv);
+    const __m128 step = _mm_div_ps(reach, _mm_sqrt_ps(distance2));
+    _mm_storeu_ps(&k.vx[i], _mm_andnot_ps(arrived, _mm_mul_ps(dx, step)));
+    _mm_storeu_ps(&k.vy[i], _mm_andnot_ps(arrived, _mm_mul_ps(dy, step)));
+
+    const __m128 heading = _mm_sub_ps(_mm_sub_ps(zero, atan2Sse(dy, dx)), quarterTurn);
+    const __m128 previous = _mm_loadu_ps(&k.heading[i]);
+    _mm_storeu_ps(&k.heading[i],
+                  _mm_or_ps(_mm_and_ps(arrived, previous), _mm_andnot_ps(arrived, heading)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&k.arrived[i]), _mm_castps_si128(arrived));
+  }
+  return end;
+}
+
+#endif
+
+} // namespace
+
+float fastAtan2(float y, float x) {
+  const float ax = std::abs(x), ay = std::abs(y);
+  const float hi = std::max(ax, ay), lo = std::min(ax, ay);
+  const float a = hi > 0 ? lo / hi : 0;
+  const float s = a * a;
+
+  float r = ((((atan_c9 * s + atan_c7) * s + atan_c5) * s + atan_c3) * s + atan_c1) * a;
+  if (ay > ax) {
+    r = glm::half_pi<float>() - r;
+  }
+  if (x < 0) {
+    r = glm::pi<float>() - r;
+  }
+  return std::signbit(y) ? -r : r;
+}
+
+void Kinematics::clear() {
+  for (auto* v : {&x, &y, &targetX, &targetY, &fromX, &fromY, &speed, &vx, &vy, &heading}) {
+    v->clear();
+  }
+  arrived.clear();
+}
+
+void Kinematics::push(float px, float py, float tx, float ty, float fx, float fy, float s,
+                      float rot) {
+  x.push_back(px);
+  y.push_back(py);
+  targetX.push_back(tx);
+  targetY.push_back(ty);
+  fromX.push_back(fx);
+  fromY.push_back(fy);
+  speed.push_back(s);
+  vx.push_back(0);
+  vy.push_back(0);
+  heading.push_back(rot);
+  arrived.push_back(0);
+}
+
+void steer(Kinematics& k, float arriveRadius, float dt) {
+  std::size_t done = 0;
+#ifdef __SSE2__
+  done = steerSse(k, arriveRadius, dt);
+#endif
+  steerScalar(k, done, arriveRadius, dt);
+}
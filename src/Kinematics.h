@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Movers' kinematic state as packed float arrays, one entry per mover
+ * @detail Kept apart from the components so the steering kernel can load four movers at once.
+ * The arrays are reused from tick to tick, so refilling them doesn't allocate.
+ */
+struct Kinematics {
+  std::vector<float> x, y;             // position
+  std::vector<float> targetX, targetY; // the waypoint being walked to
+  std::vector<float> fromX, fromY;     // where the current leg started
+  std::vector<float> speed;            // distance per second, terrain included
+
+  // filled in by steer
+  std::vector<float> vx, vy;        // displacement for this tick
+  std::vector<float> heading;       // the same angle as TransformComponent::rot
+  std::vector<std::uint32_t> arrived; // all ones if the waypoint was reached, else zero
+
+  std::size_t size() const {
+    return x.size();
+  }
+
+  void clear();
+  void push(float px, float py, float tx, float ty, float fx, float fy, float s, float rot);
+};
+
+/**
+ * @brief Steers every mover straight at its waypoint for one tick
+ * @detail A mover has arrived when it is within arriveRadius of the waypoint or has passed it
+ * along its leg; arrived movers get no displacement and keep their heading. Uses SSE four
+ * movers at a time where available, with a scalar loop for the rest.
+ */
+void steer(Kinematics& k, float arriveRadius, float dt);
+
+/// atan2 to within about 1e-5 radians, the same approximation the SIMD kernel uses
+float fastAtan2(float y, float x);
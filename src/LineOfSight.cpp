@@ -0,0 +1,33 @@
+#include "LineOfSight.h"
+
+namespace {
+
+bool traverse(const BitGrid& walkable, glm::vec2 from, glm::vec2 to) {
+  return traverseTiles(from, to,
+                       [&walkable](glm::ivec2 tile, float) { return walkable.get(tile); });
+}
+
+} // namespace
+
+bool lineOfSight(const BitGrid& walkable, glm::vec2 from, glm::vec2 to, float radius) {
+  if (not traverse(walkable, from, to)) {
+    return false;
+  }
+
+  const float length = glm::distance(from, to);
+  if (radius <= 0 || length == 0) {
+    return true;
+  }
+
+  const glm::vec2 normal = glm::vec2(from.y - to.y, to.x - from.x) * (radius / length);
+  return traverse(walkable, from + normal, to + normal) &&
+         traverse(walkable, from - normal, to - normal);
+}
+
+void lineOfSight(const BitGrid& walkable, const std::vector<SightQuery>& queries,
+                 std::vector<unsigned char>& visible, float radius) {
+  visible.resize(queries.size());
+  for (std::size_t i = 0; i < queries.size(); ++i) {
+    visible[i] = lineOfSight(walkable, queries[i].from, queries[i].to, radius);
+  }
+}
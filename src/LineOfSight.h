@@ -0,0 +1,108 @@
+#pragma once
+
+#include "BitGrid.h"
+#include "Config.h"
+
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+struct SightQuery {
+  glm::vec2 from;
+  glm::vec2 to;
+};
+
+/**
+ * @brief Walks every tile a segment passes through, in order (Amanatides & Woo)
+ * @detail The cost is proportional to the number of tiles crossed. When the segment passes
+ * exactly through a tile corner, the two tiles beside the corner are visited with length 0.
+ *
+ * @param from The start of the segment, in world coordinates
+ * @param to The end of the segment, in world coordinates
+ * @param visit Called as visit(glm::ivec2 tile, float length) with the length of the segment
+ * inside that tile; returning false stops the walk
+ *
+ * @return false if visit stopped the walk
+ */
+template <typename Visit>
+bool traverseTiles(glm::vec2 from, glm::vec2 to, Visit&& visit) {
+  const float length = glm::distance(from, to);
+  from /= tile_size;
+  to /= tile_size;
+
+  glm::ivec2 cell(std::floor(from.x), std::floor(from.y));
+  const glm::ivec2 end(std::floor(to.x), std::floor(to.y));
+
+  const glm::vec2 d = to - from;
+  const glm::ivec2 step(d.x > 0 ? 1 : -1, d.y > 0 ? 1 : -1);
+
+  // t is the parameter along the segment, 0 at from and 1 at to
+  constexpr float inf = std::numeric_limits<float>::infinity();
+  const glm::vec2 tDelta(d.x != 0 ? 1.f / std::abs(d.x) : inf,
+                         d.y != 0 ? 1.f / std::abs(d.y) : inf);
+  glm::vec2 tMax(inf, inf);
+  if (d.x != 0) {
+    tMax.x = (d.x > 0 ? cell.x + 1 - from.x : from.x - cell.x) * tDelta.x;
+  }
+  if (d.y != 0) {
+    tMax.y = (d.y > 0 ? cell.y + 1 - from.y : from.y - cell.y) * tDelta.y;
+  }
+
+  float t = 0;
+  int remaining = std::abs(end.x - cell.x) + std::abs(end.y - cell.y);
+  while (remaining > 0) {
+    const float tNext = std::min(tMax.x, tMax.y);
+    if (tNext > 1) break;
+    if (not visit(cell, (tNext - t) * length)) {
+      return false;
+    }
+    t = tNext;
+
+    if (tMax.x < tMax.y) {
+      tMax.x += tDelta.x;
+      cell.x += step.x;
+      remaining -= 1;
+    } else if (tMax.y < tMax.x) {
+      tMax.y += tDelta.y;
+      cell.y += step.y;
+      remaining -= 1;
+    } else {
+      // exactly through a corner, so the tiles beside it are touched too
+      if (not visit(glm::ivec2(cell.x + step.x, cell.y), 0.f) ||
+          not visit(glm::ivec2(cell.x, cell.y + step.y), 0.f)) {
+        return false;
+      }
+      tMax += tDelta;
+      cell += step;
+      remaining -= 2;
+    }
+  }
+
+  return visit(cell, (1 - t) * length);
+}
+
+/**
+ * @brief Exact line of sight over a walkability bitmap
+ * @detail A segment that passes exactly through a tile corner is blocked if either tile beside
+ * the corner is blocked.
+ *
+ * @param walkable Set bits are tiles that can be seen/moved through
+ * @param from The start of the segment, in world coordinates
+ * @param to The end of the segment, in world coordinates
+ * @param radius If positive, also casts the two segments offset by radius to either side, so a
+ * body of that radius fits along the whole segment
+ *
+ * @return Whether every tile touched by the segment is walkable
+ */
+bool lineOfSight(const BitGrid& walkable, glm::vec2 from, glm::vec2 to, float radius = 0.f);
+
+/**
+ * @brief Answers a batch of line of sight queries against the same bitmap
+ *
+ * @param visible Resized to queries.size(); visible[i] is 1 if queries[i] has line of sight
+ */
+void lineOfSight(const BitGrid& walkable, const std::vector<SightQuery>& queries,
+                 std::vector<unsigned char>& visible, float radius = 0.f);
@@ -0,0 +1,97 @@
+#include "OverlapSolver.h"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+void OverlapSolver::solve(const std::vector<glm::vec2>& positions,
+                          const std::vector<unsigned char>& yields, float radius,
+                          std::vector<glm::vec2>& displacement) {
+  const int n = static_cast<int>(positions.size());
+  displacement.assign(n, glm::vec2(0, 0));
+  if (n < 2) {
+    return;
+  }
+
+  // a grid over the circles' bounding box with cells at least one diameter wide, made coarser
+  // if the circles are so spread out that most cells would be empty
+  const float diameter = 2 * radius;
+  glm::vec2 lo = positions[0], hi = positions[0];
+  for (const glm::vec2& p : positions) {
+    lo = glm::min(lo, p);
+    hi = glm::max(hi, p);
+  }
+  float cell = diameter;
+  while (((hi.x - lo.x) / cell + 1) * ((hi.y - lo.y) / cell + 1) > 4.f * n + 64) {
+    cell *= 2;
+  }
+  const int width = static_cast<int>((hi.x - lo.x) / cell) + 1;
+  const int height = static_cast<int>((hi.y - lo.y) / cell) + 1;
+  const int cells = width * height;
+
+  _cellOf.resize(n);
+  _cellStart.assign(cells + 1, 0);
+  _order.resize(n);
+  for (int i = 0; i < n; ++i) {
+    const glm::ivec2 c((positions[i] - lo) / cell);
+    _cellOf[i] = c.y * width + c.x;
+    ++_cellStart[_cellOf[i] + 1];
+  }
+  for (int c = 0; c < cells; ++c) {
+    _cellStart[c + 1] += _cellStart[c];
+  }
+  for (int i = 0; i < n; ++i) { // counting sort, reusing _cellStart as the insertion cursors
+    _order[_cellStart[_cellOf[i]]++] = i;
+  }
+  for (int c = cells; c > 0; --c) {
+    _cellStart[c] = _cellStart[c - 1];
+  }
+  _cellStart[0] = 0;
+
+  auto resolve = [&](int i, int j) {
+    const glm::vec2 d = positions[j] - positions[i];
+    const float distance2 = glm::dot(d, d);
+    if (distance2 == 0 || distance2 >= diameter * diameter) {
+      return;
+    }
+
+    const float distance = std::sqrt(distance2);
+    const glm::vec2 push = d * ((diameter - distance) / distance);
+    if (yields[i] == yields[j]) {
+      displacement[i] -= push * 0.5f;
+      displacement[j] += push * 0.5f;
+    } else if (yields[i]) {
+      displacement[i] -= push;
+    } else {
+      displacement[j] += push;
+    }
+  };
+
+  // each cell against itself and the four neighbors after it, so every pair is seen once
+  const glm::ivec2 forward[] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      const int c = y * width + x;
+      for (int a = _cellStart[c]; a < _cellStart[c + 1]; ++a) {
+        for (int b = a + 1; b < _cellStart[c + 1]; ++b) {
+          resolve(_order[a], _order[b]);
+        }
+      }
+
+      for (const glm::ivec2& d : forward) {
+        const int nx = x + d.x, ny = y + d.y;
+        if (nx < 0 || nx >= width || ny >= height) {
+          continue;
+        }
+        const int o = ny * width + nx;
+        for (int a = _cellStart[c]; a < _cellStart[c + 1]; ++a) {
+          for (int b = _cellStart[o]; b < _cellStart[o + 1]; ++b) {
+            resolve(_order[a], _order[b]);
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <vector>
+
+/**
+ * @brief Pushes apart overlapping circles of the same radius
+ * @detail The broadphase counting-sorts the circles into a grid of cells at least one diameter
+ * wide, so only neighboring cells are compared, and each cell pair is visited from one side only.
+ * Every overlap is split between its two circles and summed per circle, so the caller applies
+ * one displacement each. The grid buffers are kept between calls.
+ */
+class OverlapSolver {
+  std::vector<int> _cellOf;
+  std::vector<int> _cellStart; // _order[_cellStart[c] .. _cellStart[c + 1]) are the circles in c
+  std::vector<int> _order;
+
+public:
+  /**
+   * @brief Computes how far each circle should move to stop overlapping its neighbors
+   *
+   * @param positions The circles' centers
+   * @param yields For each circle, whether it gives way entirely to a circle that doesn't. Equal
+   * circles split the overlap evenly.
+   * @param radius The radius of every circle
+   * @param displacement Set to one summed displacement per circle
+   */
+  void solve(const std::vector<glm::vec2>& positions, const std::vector<unsigned char>& yields,
+             float radius, std::vector<glm::vec2>& displacement);
+};
@@ -1,70 +1,232 @@
 #include "Path.h"
+#include "BucketQueue.h"
+#include "Config.h"
 #include "GlmHashes.h"
-#include "Grid.h"
+#include "LineOfSight.h"
+#include "Tile.h"
 #include "World.h"
 
-#include <deque>
-#include <unordered_set>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <vector>
 
-Path findPath(Region& region, glm::ivec2 start, glm::ivec2 end) {
+namespace {
+
+// path costs are ordered in steps of 1 / cost_scale in the open list
+constexpr float cost_scale = 8.f;
+
+/**
+ * @brief Per-tile search state, kept between searches
+ * @detail Big maps make a grid of this too large to keep whole, or to clear for every search,
+ * so the map is cut into block_side square blocks and a search only claims the blocks it
+ * reaches. A block is cleared the first time each search claims it, and once more blocks than
+ * path_scratch_block_budget are held, those the last search didn't reach are let go. A cell's
+ * state is kept together, and its block contiguous, since the search reads all of it for a cell
+ * and its neighbors at once.
+ */
+struct Scratch {
+  struct Node {
+    std::uint32_t mark; // stamp if open, stamp + 1 if closed
+    float cost;
+    glm::ivec2 parent;
+  };
+
+  static constexpr int block_shift = 3;
+  static constexpr int block_side = 1 << block_shift;
+  static constexpr int block_mask = block_side - 1;
+
+  struct Block {
+    std::uint32_t stamp; // of the last search that claimed it
+    std::size_t index;   // where it sits in blocks
+    std::array<Node, block_side * block_side> nodes;
+  };
+
+  int blocksPerRow = 0;
+  std::vector<Block*> blocks; // for each block of the map, or null if none is held for it
+  std::vector<std::unique_ptr<Block>> held;
+  std::uint32_t stamp = 0;
+
+  void begin(int size) {
+    const int perRow = (size + block_mask) >> block_shift;
+    if (perRow != blocksPerRow || stamp >= std::numeric_limits<std::uint32_t>::max() - 2) {
+      blocksPerRow = perRow;
+      blocks.assign(static_cast<std::size_t>(perRow) * perRow, nullptr);
+      held.clear();
+      stamp = 0;
+    }
+    stamp += 2;
+  }
+
+  /// lets go of the blocks the search just finished didn't reach, once more than the budget
+  void end() {
+    if (held.size() <= path_scratch_block_budget) {
+      return;
+    }
+    auto stale = std::partition(held.begin(), held.end(),
+                                [&](const std::unique_ptr<Block>& b) { return b->stamp == stamp; });
+    for (auto it = stale; it != held.end(); ++it) {
+      blocks[(*it)->index] = nullptr;
+    }
+    held.erase(stale, held.end());
+  }
+
+  Node& operator[](glm::ivec2 p) {
+    const std::size_t index =
+        static_cast<std::size_t>(p.y >> block_shift) * blocksPerRow + (p.x >> block_shift);
+    Block* block = blocks[index];
+    if (block == nullptr || block->stamp != stamp) {
+      block = _claim(index);
+    }
+    return block->nodes[((p.y & block_mask) << block_shift) + (p.x & block_mask)];
+  }
+
+private:
+  Block* _claim(std::size_t index) {
+    Block* block = blocks[index];
+    if (block == nullptr) {
+      held.push_back(std::make_unique<Block>());
+      block = blocks[index] = held.back().get();
+      block->index = index;
+    }
+    block->stamp = stamp;
+    block->nodes.fill(Node{0, 0, glm::ivec2(0, 0)});
+    return block;
+  }
+};
+
+} // namespace
+
+Path findPath(Region& region, glm::ivec2 start, glm::ivec2 end, float clearance) {
   using P = glm::ivec2;
 
-  std::deque<P> alive;
-  Grid<> aliveSet;
-  for (auto& v : aliveSet) {
-    v.fill(0);
+  if (not region.inBounds(start) || not region.inBounds(end)) {
+    return Path();
   }
 
-  Grid<> dead;
-  for (auto& v : dead) {
-    v.fill(0);
+  // chunks not yet generated read as blocked, so generate the ones between the two ends up
+  // front, and any others as the search reaches them
+  region.touch(glm::min(start, end) - 1, glm::max(start, end) + 1);
+  const BitGrid& walkable = region.walkability();
+
+  static thread_local Scratch scratch;
+  scratch.begin(region.size());
+
+  const std::uint32_t OPEN = scratch.stamp, CLOSED = scratch.stamp + 1;
+  auto seen = [&](P p) { return scratch[p].mark >= OPEN; };
+  auto closed = [&](P p) { return scratch[p].mark == CLOSED; };
+
+  auto dist = [](P a, P b) -> float { return glm::distance(glm::vec2(a), glm::vec2(b)); };
+  auto sees = [&](P a, P b) -> bool {
+    return lineOfSight(walkable, centerOfTile(a), centerOfTile(b), clearance);
+  };
+
+  // there are only a few tile types, so look their costs up once
+  std::array<float, tile_count> costOfType;
+  for (int t = 0; t < static_cast<int>(costOfType.size()); ++t) {
+    costOfType[t] = TileProperties::of(static_cast<Tile>(t)).moveCost;
   }
+  auto tileCost = [&](P p) -> float { return costOfType[static_cast<int>(region.tile(p))]; };
+  const float cheapest = TileProperties::cheapestMoveCost();
+  auto estimate = [&](P p) -> float { return dist(p, end) * cheapest; };
 
-  alive.push_back(start);
-  aliveSet[start.x][start.y] = 1;
+  // a grid step is half in each tile, diagonal steps included since they cross at the corner
+  auto stepCost = [&](P a, P b) -> float { return dist(a, b) * (tileCost(a) + tileCost(b)) / 2; };
+  // summed in double, or long legs on big maps drift further than the tolerance below
+  auto legCost = [&](P a, P b) -> float {
+    double result = 0;
+    traverseTiles(centerOfTile(a), centerOfTile(b), [&](P tile, float length) {
+      result += length * tileCost(tile);
+      return true;
+    });
+    return static_cast<float>(result);
+  };
 
-  auto valid = [&region](P p) -> bool {
-    return region.inBounds(p) && TileProperties::of(region[p.x][p.y]).walkable &&
-           (not region.structureAt(p));
+  BucketQueue<P> open(128);
+  auto push = [&](P p) {
+    open.push(static_cast<std::size_t>((scratch[p].cost + estimate(p)) * cost_scale), p);
   };
 
-  auto seen = [&](P p) -> bool { return aliveSet[p.x][p.y] || dead[p.x][p.y]; };
+  scratch[start].cost = 0;
+  scratch[start].parent = start;
+  scratch[start].mark = OPEN;
+  push(start);
 
-  Grid<P> backtrace;
-  for (auto& v : backtrace) {
-    v.fill(P(-1, -1));
-  }
+  const std::array<P, 8> directions = {P(0, 1), P(0, -1), P(1, 0),  P(-1, 0),
+                                       P(1, 1), P(1, -1), P(-1, 1), P(-1, -1)};
 
-  while (not alive.empty()) {
-    auto curr = alive.front();
-    alive.pop_front();
-    aliveSet[curr.x][curr.y] = 0;
+  // diagonal steps must not cut the corner of a blocked tile
+  auto step = [&](P from, P d) -> bool {
+    const P to = from + d;
+    region.touch(to);
+    if (not walkable.get(to)) {
+      return false;
+    }
+    return d.x == 0 || d.y == 0 ||
+           (walkable.get({from.x + d.x, from.y}) && walkable.get({from.x, from.y + d.y}));
+  };
+
+  while (not open.empty()) {
+    const P curr = open.pop();
+
+    if (closed(curr)) {
+      continue; // stale entry
+    }
+    scratch[curr].mark = CLOSED;
+
+    // curr was queued with an estimate of the straight leg from its parent. Settle the real
+    // cost of that leg, or fall back to the best closed grid neighbor if the leg is blocked or
+    // clearly more expensive (ties keep the straight leg).
+    P& p = scratch[curr].parent;
+    if (p != curr) {
+      constexpr float tolerance = 1e-3f;
+      float best = sees(p, curr) ? scratch[p].cost + legCost(p, curr)
+                                 : std::numeric_limits<float>::infinity();
+      for (const P& d : directions) {
+        const P n = curr - d;
+        if (region.inBounds(n) && closed(n) && step(n, d) &&
+            scratch[n].cost + stepCost(n, curr) < best - tolerance) {
+          best = scratch[n].cost + stepCost(n, curr);
+          p = n;
+        }
+      }
+      scratch[curr].cost = best;
+    }
 
     if (curr == end) {
       Path trace;
-      auto curr = end;
-      while (curr != start) {
-        trace.push_front(curr);
-        curr = backtrace[curr.x][curr.y];
+      for (P at = end; at != start; at = scratch[at].parent) {
+        trace.push_back(at);
       }
-
+      std::reverse(trace.begin(), trace.end());
+      scratch.end();
       return trace;
     }
-    dead[curr.x][curr.y] = 1;
 
-    const std::array<P, 4> neighbors = {curr + P(0, 1), curr + P(0, -1), curr + P(1, 0),
-                                        curr + P(-1, 0)};
+    // neighbors are queued as a straight leg from grandparent, at the average rate of the
+    // settled leg to curr and the step onto the neighbor
+    const P grandparent = scratch[curr].parent;
+    const float legSoFar = scratch[curr].cost - scratch[grandparent].cost;
+    for (const P& d : directions) {
+      const P n = curr + d;
+      if (not step(curr, d) || closed(n)) {
+        continue;
+      }
 
-    // get valid neighbors
-    for (auto& n : neighbors) {
-      if (valid(n) && not seen(n)) {
-        backtrace[n.x][n.y] = curr;
-        alive.push_back(n);
-        aliveSet[n.x][n.y] = 1;
+      const float rate = (legSoFar + dist(curr, n) * tileCost(n)) /
+                         (dist(grandparent, curr) + dist(curr, n));
+      const float newCost = scratch[grandparent].cost + dist(grandparent, n) * rate;
+      if (not seen(n) || newCost < scratch[n].cost) {
+        scratch[n].mark = OPEN;
+        scratch[n].cost = newCost;
+        scratch[n].parent = grandparent;
+        push(n);
       }
     }
   }
 
+  scratch.end();
   return Path();
 }
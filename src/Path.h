@@ -1,11 +1,22 @@
 #pragma once
 
-#include <deque>
 #include <glm/vec2.hpp>
 
 #include "Region.h"
+#include "SmallVector.h"
 
-using Path = std::deque<glm::ivec2>;
+// any-angle paths are usually only a few legs long, so most fit without allocating
+using Path = SmallVector<glm::ivec2, 6>;
 
-/// returns an empty path on failure
-Path findPath(Region& region, glm::ivec2 start, glm::ivec2 end);
\ No newline at end of file
+/**
+ * @brief Plans an any-angle path over the tile grid (Lazy Theta*)
+ * @detail Searches the 8-connected grid of tile centers without cutting corners, but lets each
+ * cell inherit its parent's parent whenever there is line of sight, so the result is already a
+ * short list of straight-line waypoints. Distance is weighted by each tile's moveCost, and the
+ * open list is a bucket queue since costs are small and only grow.
+ *
+ * @param clearance The body radius that has to fit along every straight leg
+ *
+ * @return The waypoints after start, ending with end; empty on failure
+ */
+Path findPath(Region& region, glm::ivec2 start, glm::ivec2 end, float clearance = 0.f);
@@ -0,0 +1,119 @@
+#include "PathCache.h"
+#include "Tile.h"
+#include "LineOfSight.h"
+
+#include <cmath>
+
+constexpr float PathCache::corridor_radius;
+
+Path PathCache::find(Region& region, glm::ivec2 start, glm::ivec2 goal, float clearance) {
+  const Key key{start, goal};
+
+  auto it = _index.find(key);
+  if (it != _index.end()) {
+    Entry& entry = *it->second;
+    if (entry.clearance == clearance && _catchUp(region, entry)) {
+      _entries.splice(_entries.begin(), _entries, it->second);
+      ++_stats.hits;
+      return entry.path;
+    }
+    _entries.erase(it->second);
+    _index.erase(it);
+  }
+
+  Path path;
+  if (_splice(region, start, goal, clearance, path)) {
+    ++_stats.splices;
+  } else {
+    ++_stats.misses;
+    path = findPath(region, start, goal, clearance);
+  }
+
+  _insert(region, key, clearance, path);
+  return path;
+}
+
+bool PathCache::_splice(const Region& region, glm::ivec2 start, glm::ivec2 goal, float clearance,
+                        Path& result) {
+  const glm::vec2 from = centerOfTile(start);
+
+  for (Entry& entry : _entries) {
+    if (entry.key.goal != goal || entry.clearance != clearance || entry.path.empty() ||
+        not _catchUp(region, entry)) {
+      continue;
+    }
+
+    // find the leg passing closest to start, then join the path where that leg ends
+    const Path& path = entry.path;
+    glm::vec2 a = centerOfTile(entry.key.start);
+    float bestDistance = corridor_radius * tile_size;
+    std::size_t best = path.size();
+    for (std::size_t i = 0; i < path.size(); ++i) {
+      const glm::vec2 b = centerOfTile(path[i]);
+      const glm::vec2 ab = b - a;
+      const float t =
+          glm::clamp(glm::dot(from - a, ab) / std::max(glm::dot(ab, ab), 1e-6f), 0.f, 1.f);
+      const float d = glm::distance(from, a + ab * t);
+      if (d <= bestDistance) {
+        bestDistance = d;
+        best = i;
+      }
+      a = b;
+    }
+
+    if (best < path.size() &&
+        lineOfSight(region.walkability(), from, centerOfTile(path[best]), clearance)) {
+      if (path[best] == start) {
+        ++best;
+      }
+      result.assign(path.begin() + best, path.end());
+      return not result.empty();
+    }
+  }
+
+  return false;
+}
+
+bool PathCache::_catchUp(const Region& region, Entry& entry) const {
+  if (entry.version == region.navVersion()) {
+    return true;
+  }
+
+  bool current = true;
+  auto check = [&](const ChangeJournal::Change& c) {
+    if (not c.nav) {
+      return;
+    }
+    current = current && not c.opened &&
+              (c.hi.x < entry.lo.x || c.lo.x > entry.hi.x || c.hi.y < entry.lo.y ||
+               c.lo.y > entry.hi.y);
+  };
+  const bool known = region.changes().forEachSince(entry.version, check);
+  if (not known || not current) {
+    return false;
+  }
+
+  entry.version = region.navVersion();
+  return true;
+}
+
+void PathCache::_insert(const Region& region, Key key, float clearance, const Path& path) {
+  // legs run straight between waypoints, so the waypoints' bounds hold them; the margin covers
+  // obstacles close enough to eat into clearance
+  glm::ivec2 lo = key.start, hi = key.start;
+  for (const glm::ivec2& p : path) {
+    lo = glm::min(lo, p);
+    hi = glm::max(hi, p);
+  }
+  const int margin = static_cast<int>(std::ceil(clearance)) + 1;
+
+  _entries.push_front(
+      Entry{key, clearance, region.navVersion(), lo - margin, hi + margin, path});
+  _index[key] = _entries.begin();
+
+  while (_entries.size() > _capacity) {
+    _index.erase(_entries.back().key);
+    _entries.pop_back();
+    ++_stats.evictions;
+  }
+}
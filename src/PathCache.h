@@ -0,0 +1,87 @@
+#pragma once
+
+#include "GlmHashes.h"
+#include "Path.h"
+#include "Region.h"
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+struct PathCacheStats {
+  std::size_t hits = 0;      // exact (start, goal) matches
+  std::size_t splices = 0;   // started on the corridor of a cached path to the same goal
+  std::size_t misses = 0;    // had to search
+  std::size_t evictions = 0; // dropped for being least recently used
+};
+
+/**
+ * @brief Least recently used cache of solved paths in front of findPath
+ * @detail Entries are keyed on (start cell, goal cell) and stamped with the Region's navVersion.
+ * An older entry is brought up to date from the Region's change journal: it stays good while
+ * every change since only blocked tiles away from its path, and goes stale on a change near the
+ * path or one that opened tiles anywhere, since that may have made a shorter path. Changes that
+ * leave walkability and move costs as they were don't count. A start cell near one of the legs
+ * of a cached path to the same goal reuses the rest of that path, as long as it can see where
+ * the leg ends.
+ */
+class PathCache {
+  struct Key {
+    glm::ivec2 start, goal;
+
+    bool operator==(const Key& o) const {
+      return start == o.start && goal == o.goal;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& k) const {
+      return std::hash<glm::ivec2>()(k.start) * 31 ^ std::hash<glm::ivec2>()(k.goal);
+    }
+  };
+
+  struct Entry {
+    Key key;
+    float clearance;
+    std::uint64_t version;
+    glm::ivec2 lo, hi; // the tiles whose changes could spoil path, inclusive
+    Path path;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  // how far from a cached leg, in tiles, a start cell may be to splice into it
+  static constexpr float corridor_radius = 1.5f;
+
+  EntryList _entries; // most recently used first
+  std::unordered_map<Key, EntryList::iterator, KeyHash> _index;
+  std::size_t _capacity;
+  PathCacheStats _stats;
+
+  /// whether entry is still good for region, restamping it if so
+  bool _catchUp(const Region& region, Entry& entry) const;
+  bool _splice(const Region& region, glm::ivec2 start, glm::ivec2 goal, float clearance,
+               Path& result);
+  void _insert(const Region& region, Key key, float clearance, const Path& path);
+
+public:
+  explicit PathCache(std::size_t capacity = 256) : _capacity(capacity) {}
+
+  /// the same as findPath, but reuses earlier results while the region hasn't changed
+  Path find(Region& region, glm::ivec2 start, glm::ivec2 goal, float clearance = 0.f);
+
+  const PathCacheStats& stats() const {
+    return _stats;
+  }
+
+  std::size_t size() const {
+    return _entries.size();
+  }
+
+  void clear() {
+    _entries.clear();
+    _index.clear();
+  }
+};
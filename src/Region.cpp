@@ -1,29 +1,201 @@
 #include "Region.h"
 
-bool Region::structureAt(glm::ivec2 cell) const {
-  if (not inBounds({cell.x, cell.y})) {
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+// chunks one generator thread should get at least, or starting it costs more than it saves
+constexpr std::size_t chunks_per_thread = 4;
+
+/// calls fn(begin, end) over contiguous bands of [0, count), on several threads if it's worth it
+template <typename F>
+void forEachBand(std::size_t count, F&& fn) {
+  const std::size_t threads = std::max<std::size_t>(
+      1, std::min<std::size_t>(std::thread::hardware_concurrency(), count / chunks_per_thread));
+  std::vector<std::thread> workers;
+  for (std::size_t t = 1; t < threads; ++t) {
+    workers.emplace_back(fn, count * t / threads, count * (t + 1) / threads);
+  }
+  fn(0, count / threads);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+} // namespace
+
+constexpr int Region::chunk_shift;
+constexpr int Region::chunk_size;
+
+Region::Region(int size, Tile fill)
+    : _size(size), _chunksPerSide((size + chunk_size - 1) / chunk_size),
+      _slots(static_cast<std::size_t>(_chunksPerSide) * _chunksPerSide),
+      _generator([fill](glm::ivec2, Chunk& tiles) { tiles.fill(fill); }),
+      _walkable(size, size),
+      _obstacleDistance(_walkable) {}
+
+void Region::touch(glm::ivec2 lo, glm::ivec2 hi) {
+  lo = glm::max(lo, glm::ivec2(0, 0));
+  hi = glm::min(hi, glm::ivec2(_size - 1, _size - 1));
+  if (lo.x > hi.x || lo.y > hi.y) {
+    return;
+  }
+
+  std::vector<glm::ivec2> fresh; // row by row, so threads below get bands of rows
+  for (int y = lo.y >> chunk_shift; y <= hi.y >> chunk_shift; ++y) {
+    for (int x = lo.x >> chunk_shift; x <= hi.x >> chunk_shift; ++x) {
+      if (not _slots[static_cast<std::size_t>(y) * _chunksPerSide + x].generated) {
+        fresh.push_back({x, y});
+      }
+    }
+  }
+  if (fresh.empty()) {
+    return;
+  }
+
+  // generate everything in as few batches as the budget allows, then fix the distance field up
+  // once for all of it
+  for (std::size_t begin = 0; begin < fresh.size(); begin += _chunkBudget) {
+    const std::size_t end = std::min(fresh.size(), begin + _chunkBudget);
+    _generate(fresh.data() + begin, fresh.data() + end);
+  }
+
+  glm::ivec2 changedLo = fresh.front(), changedHi = fresh.front();
+  for (const glm::ivec2& chunk : fresh) {
+    changedLo = glm::min(changedLo, chunk);
+    changedHi = glm::max(changedHi, chunk);
+  }
+  changedLo *= chunk_size;
+  changedHi = glm::min((changedHi + 1) * chunk_size - 1, glm::ivec2(_size - 1, _size - 1));
+  _obstacleDistance.update(_walkable, changedLo, changedHi);
+  _changes.record(changedLo, changedHi, false);
+}
+
+void Region::setChunkBudget(std::size_t chunks) {
+  _chunkBudget = std::max<std::size_t>(chunks, 1);
+  while (_residentChunks > _chunkBudget) {
+    _evict();
+  }
+}
+
+bool Region::addStructure(glm::ivec2 cell, ECS::Entity structure) {
+  if (not inBounds({cell.x, cell.y}) || structure == ECS::InvalidEntityId) {
+    return false;
+  }
+
+  if (not _structures.emplace(_cellKey(cell), structure).second) {
     return false;
   }
 
-  return _structure_pos_set[cell.x][cell.y];
+  _updateWalkable(cell, _tile(cell));
+  return true;
 }
 
-void Region::addStructure(glm::ivec2 cell) {
+void Region::removeStructure(glm::ivec2 cell) {
   if (not inBounds({cell.x, cell.y})) {
     return;
   }
 
-  _structure_pos_set[cell.x][cell.y] = 1;
+  if (_structures.erase(_cellKey(cell)) == 0) {
+    return;
+  }
+
+  _updateWalkable(cell, _tile(cell));
 }
 
-void Region::removeStructure(glm::ivec2 cell) {
+void Region::setCell(glm::ivec2 cell, Tile t) {
   if (not inBounds({cell.x, cell.y})) {
     return;
   }
 
-  _structure_pos_set[cell.x][cell.y] = 0;
+  const Tile before = _tile(cell);
+  if (before == t) {
+    return;
+  }
+
+  _setTile(cell, t);
+  _updateWalkable(cell, before);
 }
 
 bool Region::inBounds(glm::vec2 p) const {
-  return p.x >= 0 && p.y >= 0 && p.x < world_size && p.y < world_size;
+  return p.x >= 0 && p.y >= 0 && p.x < _size && p.y < _size;
+}
+
+void Region::_load(glm::ivec2 p) {
+  const std::size_t i = _chunkOf(p);
+  if (_slots[i].generated) {
+    _makeResident(i);
+    _pageFile.read(i, _slots[i].tiles->data());
+  } else {
+    touch(p, p);
+  }
+}
+
+void Region::_generate(const glm::ivec2* first, const glm::ivec2* last) {
+  auto slotOf = [this](glm::ivec2 chunk) -> Slot& {
+    return _slots[static_cast<std::size_t>(chunk.y) * _chunksPerSide + chunk.x];
+  };
+
+  // make room for the whole batch first; pinned chunks are passed over by the clock
+  for (const glm::ivec2* chunk = first; chunk != last; ++chunk) {
+    _makeResident(static_cast<std::size_t>(chunk->y) * _chunksPerSide + chunk->x);
+    slotOf(*chunk).pinned = true;
+  }
+
+  forEachBand(last - first, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      _generator(first[i] * chunk_size, *slotOf(first[i]).tiles);
+    }
+  });
+
+  for (const glm::ivec2* chunk = first; chunk != last; ++chunk) {
+    Slot& slot = slotOf(*chunk);
+    slot.generated = true;
+    slot.dirty = true;
+    slot.pinned = false;
+    ++_generatedChunks;
+
+    const glm::ivec2 origin = *chunk * chunk_size;
+    const glm::ivec2 end = glm::min(origin + chunk_size, glm::ivec2(_size, _size));
+    for (int y = origin.y; y < end.y; ++y) {
+      for (int x = origin.x; x < end.x; ++x) {
+        const glm::ivec2 p(x, y);
+        _walkable.set(p, TileProperties::of((*slot.tiles)[_offsetInChunk(p)]).walkable &&
+                             not _isBuiltOn(p));
+      }
+    }
+  }
+}
+
+void Region::_makeResident(std::size_t i) {
+  std::unique_ptr<Chunk> tiles =
+      _residentChunks >= _chunkBudget ? _evict() : std::unique_ptr<Chunk>(new Chunk);
+  _slots[i].tiles = std::move(tiles);
+  _slots[i].referenced = true;
+  ++_residentChunks;
+}
+
+std::unique_ptr<Region::Chunk> Region::_evict() {
+  // the clock passes over recently used chunks once, clearing their bit, so it always stops
+  for (;; _clockHand = (_clockHand + 1) % _slots.size()) {
+    Slot& slot = _slots[_clockHand];
+    if (not slot.tiles || slot.pinned) {
+      continue;
+    }
+    if (slot.referenced) {
+      slot.referenced = false;
+      continue;
+    }
+
+    if (slot.dirty) {
+      if (not _pageFile.isOpen()) {
+        _pageFile = ChunkFile(_slots.size(), sizeof(Chunk));
+      }
+      _pageFile.write(_clockHand, slot.tiles->data());
+      slot.dirty = false;
+    }
+    --_residentChunks;
+    return std::move(slot.tiles);
+  }
 }
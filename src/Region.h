@@ -1,73 +1,248 @@
 #pragma once
 
+#include "BitGrid.h"
+#include "ChangeJournal.h"
+#include "ChunkFile.h"
 #include "Config.h"
+#include "DistanceField.h"
+#include "ECS/Entity.h"
 #include "GlmHashes.h"
-#include "Graphics.h"
-#include "Grid.h"
 #include "Tile.h"
 
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
-// Forward declaration
-class RegionGenerator;
-
+class TextureBatch;
+
+/**
+ * @brief The map's terrain, structures and walkability, any size, streamed in chunks
+ * @detail Terrain is kept a byte per tile in chunk_size square chunks, each one contiguous, so
+ * a whole chunk is a few cache lines and nothing is allocated per row. Chunks run row by row,
+ * and a map that isn't a whole number of chunks has unused tiles in its last row and column.
+ *
+ * A chunk is generated the first time anything touches it: reading a tile on it, or touch()
+ * from pathing and spawning. Until then its tiles count as unwalkable. A touch that covers many
+ * chunks generates them on several threads, so the generator must be safe to call
+ * concurrently. At most chunkBudget() chunks are kept in memory; past that, the least recently
+ * used one (by the clock algorithm) is written out to a ChunkFile and read back when it is next
+ * needed. Structures are kept only for the tiles built on. The walkability bits and obstacle
+ * distances are derived per tile and stay in memory for the whole map, about 12 bytes a tile
+ * against the terrain's one, so memory is bounded by that plus chunkBudget() chunks of 1KB.
+ *
+ * Every edit, and every batch of generated chunks, is recorded in changes(), so whatever is
+ * derived from the tiles elsewhere can redo just what changed. Generating isn't counted as
+ * opening tiles: pathing generates every chunk it reaches, so it never went around one.
+ */
 class Region {
-  std::vector<std::vector<Tile>> _data;
-  Grid<> _structure_pos_set;
+public:
+  static constexpr int chunk_shift = 5;
+  static constexpr int chunk_size = 1 << chunk_shift; // tiles along each side of a chunk
+
+  using Chunk = std::array<Tile, chunk_size * chunk_size>; // row by row
+  /// fills in the chunk whose first tile is origin; may be called from several threads at once
+  using ChunkGenerator = std::function<void(glm::ivec2 origin, Chunk& tiles)>;
+
+private:
+  struct Slot {
+    std::unique_ptr<Chunk> tiles; // null unless resident
+    bool generated = false;  // once generated, a chunk that isn't resident is in _pageFile
+    bool dirty = false;      // changed since it was last written to _pageFile
+    bool referenced = false; // used since the clock hand last passed it
+    bool pinned = false;     // being generated, so not to be evicted
+  };
+
+  int _size;          // tiles along each side
+  int _chunksPerSide;
+  std::vector<Slot> _slots;
+  ChunkGenerator _generator;
+
+  std::size_t _chunkBudget = resident_chunk_budget;
+  std::size_t _residentChunks = 0;
+  std::size_t _generatedChunks = 0;
+  std::size_t _clockHand = 0;
+  ChunkFile _pageFile; // opened the first time a chunk is paged out
+
+  // the structure entity standing on each built-on tile, by _cellKey; the one record of which
+  // tiles are built on, and only as big as the number of structures
+  std::unordered_map<std::size_t, ECS::Entity> _structures;
+
+  // walkable terrain without a structure on it, kept in step with every edit
+  BitGrid _walkable;
+  DistanceField _obstacleDistance; // to the nearest tile that isn't _walkable
+
+  // every change to terrain, structures or walkability
+  ChangeJournal _changes;
+
+  // what draw() showed last: each tile's texture over [_drawnLo, _drawnHi], row by row
+  std::vector<float> _drawnTextures;
+  glm::ivec2 _drawnLo{0, 0}, _drawnHi{-1, -1};
+  std::uint64_t _drawnVersion = 0;
+
+  std::size_t _chunkOf(glm::ivec2 p) const {
+    return static_cast<std::size_t>(p.y >> chunk_shift) * _chunksPerSide + (p.x >> chunk_shift);
+  }
+
+  static std::size_t _offsetInChunk(glm::ivec2 p) {
+    return (p.y & (chunk_size - 1)) * chunk_size + (p.x & (chunk_size - 1));
+  }
+
+  // p must be in bounds
+  Chunk& _chunk(glm::ivec2 p) {
+    Slot& slot = _slots[_chunkOf(p)];
+    if (not slot.tiles) {
+      _load(p);
+    }
+    slot.referenced = true;
+    return *slot.tiles;
+  }
+
+  Tile _tile(glm::ivec2 p) {
+    return _chunk(p)[_offsetInChunk(p)];
+  }
 
-  friend RegionGenerator;
+  void _setTile(glm::ivec2 p, Tile t) {
+    _chunk(p)[_offsetInChunk(p)] = t;
+    _slots[_chunkOf(p)].dirty = true;
+  }
+
+  // row by row over the whole map, unlike the ivec2 hash, which is the same along diagonals
+  std::size_t _cellKey(glm::ivec2 cell) const {
+    return static_cast<std::size_t>(cell.y) * _size + cell.x;
+  }
+
+  bool _isBuiltOn(glm::ivec2 cell) const {
+    return _structures.count(_cellKey(cell)) != 0;
+  }
+
+  bool _isWalkable(glm::ivec2 cell) {
+    return TileProperties::of(_tile(cell)).walkable && not _isBuiltOn(cell);
+  }
+
+  /// before: the cell's terrain before the edit, the same as now if only a structure changed
+  void _updateWalkable(glm::ivec2 cell, Tile before) {
+    const bool was = _walkable.get(cell);
+    const bool walkable = _isWalkable(cell);
+    if (walkable != was) {
+      _walkable.set(cell, walkable);
+      _obstacleDistance.update(_walkable, cell);
+    }
+
+    // what a tile no path can cross costs doesn't matter
+    const int cost = TileProperties::of(_tile(cell)).moveCost;
+    const int costBefore = TileProperties::of(before).moveCost;
+    const bool nav = walkable != was || (walkable && cost != costBefore);
+    _changes.record(cell, cell, walkable && (not was || cost < costBefore), nav);
+  }
+
+  /// refreshes _drawnTextures over the inclusive rectangle [lo, hi], which must lie in it
+  void _redrawTiles(glm::ivec2 lo, glm::ivec2 hi);
+
+  void _load(glm::ivec2 p);
+  /// generates the chunks in [first, last), at most _chunkBudget of them, across threads
+  void _generate(const glm::ivec2* first, const glm::ivec2* last);
+  void _makeResident(std::size_t i);
+  std::unique_ptr<Chunk> _evict();
 
 public:
-  Region(std::vector<std::vector<Tile>> data) : _data(data) {
-    for (auto& v : _structure_pos_set) {
-      v.fill(0);
+  /// a size by size map covered in fill, unless another generator is set before it's touched
+  explicit Region(int size, Tile fill = Tile::GRASS);
+
+  int size() const {
+    return _size;
+  }
+
+  /// how chunks are generated; chunks that already have been keep their tiles
+  void setGenerator(ChunkGenerator generator) {
+    _generator = std::move(generator);
+  }
+
+  /// generates every chunk overlapping the inclusive rectangle [lo, hi] that isn't yet
+  void touch(glm::ivec2 lo, glm::ivec2 hi);
+
+  void touch(glm::ivec2 cell) {
+    if (inBounds(cell) && not _slots[_chunkOf(cell)].generated) {
+      touch(cell, cell);
     }
   }
 
-  std::vector<Tile>& operator[](size_t i) {
-    return _data[i];
+  /// most chunks kept in memory at once, at least 1
+  void setChunkBudget(std::size_t chunks);
+
+  std::size_t chunkBudget() const {
+    return _chunkBudget;
+  }
+
+  std::size_t residentChunks() const {
+    return _residentChunks;
+  }
+
+  std::size_t generatedChunks() const {
+    return _generatedChunks;
   }
 
-  Tile& at(glm::ivec2 p) {
+  /// Tile::NONE off the map
+  Tile at(glm::ivec2 p) {
     if (not inBounds({p.x, p.y})) {
-      return _data[0][0]; // What else could we return here?
+      return Tile::NONE;
     }
 
-    return _data[p.x][p.y];
-  }
-
-  void draw(TextureBatch& batch) const {
-    const glm::vec2 offset(-tile_size * 0.5, -tile_size * 0.5);
-    View& view = batch.view();
-
-    for (uint i = 0; i < _data.size(); ++i) {
-      for (uint j = 0; j < _data[i].size(); ++j) {
-        // clang-format off
-        if ( // cpu view culling
-          (i + 1) * tile_size  < view.left()   ||
-          view.right()         < i * tile_size ||
-          (j + 1) * tile_size  < view.bottom() ||
-          view.top()           < j * tile_size 
-        ) continue;
-        // clang-format on
-
-        float texi = TileProperties::of(_data[i][j]).texOffset;
-        auto pos = glm::vec2{i * tile_size, j * tile_size} - offset;
-
-        TextureBatch::Instance inst;
-        inst.pos = pos;
-        inst.size = {tile_size, tile_size};
-        inst.texOffset = texi;
-        batch.add(std::move(inst));
-      }
-    }
+    return _tile(p);
+  }
+
+  /// at() without the bounds check, for loops that already stay on the map
+  Tile tile(glm::ivec2 p) {
+    return _tile(p);
   }
 
-  bool structureAt(glm::ivec2 cell) const;
-  void addStructure(glm::ivec2 cell);
+  void setCell(glm::ivec2 cell, Tile t);
+
+  /// generates whatever is in view; only looks tiles up again where the view or they changed
+  void draw(TextureBatch& batch);
+
+  /// the structure on cell, or ECS::InvalidEntityId if it isn't built on
+  ECS::Entity structureAt(glm::ivec2 cell) const {
+    if (not inBounds({cell.x, cell.y})) {
+      return ECS::InvalidEntityId;
+    }
+    const auto it = _structures.find(_cellKey(cell));
+    return it == _structures.end() ? ECS::InvalidEntityId : it->second;
+  }
 
+  /// places structure on cell, unless the cell is off the region or already built on
+  bool addStructure(glm::ivec2 cell, ECS::Entity structure);
   void removeStructure(glm::ivec2 cell);
 
+  /// the tiles that can be walked on: walkable terrain without a structure, on generated chunks
+  const BitGrid& walkability() const {
+    return _walkable;
+  }
+
+  bool walkable(glm::ivec2 cell) const {
+    return _walkable.get(cell);
+  }
+
+  const DistanceField& obstacleDistance() const {
+    return _obstacleDistance;
+  }
+
+  /// whether a circle at pos stays clear of every unwalkable tile
+  bool clearAt(glm::vec2 pos, float radius) const {
+    return _obstacleDistance.sample(pos).distance >= radius;
+  }
+
+  /// bumped whenever walkability or move costs change, so cached paths can tell they're stale
+  std::uint64_t navVersion() const {
+    return _changes.version();
+  }
+
+  const ChangeJournal& changes() const {
+    return _changes;
+  }
+
   bool inBounds(glm::vec2 pos) const;
 };
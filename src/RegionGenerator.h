@@ -8,7 +8,13 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <algorithm>
+#include <cmath>
 #include <random>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 class PerlinNoise {
   const int _seed;
@@ -17,10 +23,12 @@ class PerlinNoise {
   double _lacunarity = 2.0;
   std::vector<int> _randomData;
 
-  int _hash(uint x) {
-    if (x >= _randomData.size()) {
-      throw std::runtime_error("input to PerlinNoise::_hash out of bounds.");
-    }
+  // _grad(h, x, y, 0) == _gradX[h & 15] * x + _gradY[h & 15] * y, each coefficient -1, 0 or 1
+  float _gradX[16];
+  float _gradY[16];
+
+  // x is always under 2 * 256: coordinates are masked to 255 and hashes are at most 255
+  int _hash(unsigned x) const {
     return _randomData[x];
   }
 
@@ -37,6 +45,93 @@ class PerlinNoise {
     return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
   }
 
+  // the float kernels below evaluate in the same order, so every path gives the same bits
+  static float _fade(float t) {
+    return t * t * t * (t * (t * 6 - 15) + 10);
+  }
+  static float _lerp(float t, float a, float b) {
+    return a + t * (b - a);
+  }
+
+  // the hashes of the four corners around cell (X, Y)
+  struct Corners {
+    int aa, ba, ab, bb;
+  };
+
+  Corners _corners(int X, int Y) const {
+    const int A = _hash(X) + Y, B = _hash(X + 1) + Y;
+    return Corners{_hash(_hash(A)) & 15, _hash(_hash(B)) & 15, _hash(_hash(A + 1)) & 15,
+                   _hash(_hash(B + 1)) & 15};
+  }
+
+  /// one octave of the z = 0 slice at (x, y), already scaled by frequency
+  float _octave2D(float x, float y) const {
+    const float fx = std::floor(x), fy = std::floor(y);
+    const Corners c = _corners(static_cast<int>(fx) & 255, static_cast<int>(fy) & 255);
+    x -= fx;
+    y -= fy;
+    const float u = _fade(x), v = _fade(y);
+
+    const float aa = _gradX[c.aa] * x + _gradY[c.aa] * y;
+    const float ba = _gradX[c.ba] * (x - 1) + _gradY[c.ba] * y;
+    const float ab = _gradX[c.ab] * x + _gradY[c.ab] * (y - 1);
+    const float bb = _gradX[c.bb] * (x - 1) + _gradY[c.bb] * (y - 1);
+    return _lerp(v, _lerp(u, aa, ba), _lerp(u, ab, bb));
+  }
+
+  static constexpr float sqrt_3 = 1.7320508f;
+
+  /// maps the summed octaves to [0, 1], as generate() does
+  static float _finish(float result) {
+    return std::max(0.f, std::min(1.f, result / sqrt_3 + 0.5f));
+  }
+
+#ifdef __SSE2__
+  /// adds amp times one octave at (x0 + i) * freq, y * freq into out[i], for i in [0, count)
+  /// where count is a multiple of 4
+  void _octaveRowSse(int x0, float y, float freq, float amp, int count, float* out) const {
+    const float fy = std::floor(y);
+    const int Y = static_cast<int>(fy) & 255;
+    y -= fy;
+    const float v = _fade(y);
+    const __m128 yv = _mm_set1_ps(y), y1 = _mm_set1_ps(y - 1), vv = _mm_set1_ps(v);
+    const __m128 one = _mm_set1_ps(1), six = _mm_set1_ps(6), fifteen = _mm_set1_ps(15),
+                 ten = _mm_set1_ps(10), ampv = _mm_set1_ps(amp);
+
+    alignas(16) float xs[4], gx[4][4], gy[4][4];
+    for (int i = 0; i < count; i += 4) {
+      // SSE2 has no floor or gather, so lanes find their cell and corner gradients one by one
+      for (int lane = 0; lane < 4; ++lane) {
+        const float x = static_cast<float>(x0 + i + lane) * freq;
+        const float fx = std::floor(x);
+        const Corners c = _corners(static_cast<int>(fx) & 255, Y);
+        xs[lane] = x - fx;
+        const int corner[] = {c.aa, c.ba, c.ab, c.bb};
+        for (int k = 0; k < 4; ++k) {
+          gx[k][lane] = _gradX[corner[k]];
+          gy[k][lane] = _gradY[corner[k]];
+        }
+      }
+
+      const __m128 x = _mm_load_ps(xs), x1 = _mm_sub_ps(x, one);
+      const __m128 u = _mm_mul_ps(
+          _mm_mul_ps(_mm_mul_ps(x, x), x),
+          _mm_add_ps(_mm_mul_ps(x, _mm_sub_ps(_mm_mul_ps(x, six), fifteen)), ten));
+
+      auto dot = [&](int k, __m128 px, __m128 py) {
+        return _mm_add_ps(_mm_mul_ps(_mm_load_ps(gx[k]), px), _mm_mul_ps(_mm_load_ps(gy[k]), py));
+      };
+      auto lerp = [](__m128 t, __m128 a, __m128 b) {
+        return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+      };
+      const __m128 noise =
+          lerp(vv, lerp(u, dot(0, x, yv), dot(1, x1, yv)), lerp(u, dot(2, x, y1), dot(3, x1, y1)));
+
+      _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(noise, ampv)));
+    }
+  }
+#endif
+
 public:
   PerlinNoise(int seed) : _seed(seed) {
     // construct vector of [0..255]
@@ -49,6 +144,11 @@ public:
     std::random_shuffle(_randomData.begin(), _randomData.end(), randfunc);
 
     _randomData.insert(_randomData.end(), _randomData.begin(), _randomData.end());
+
+    for (int h = 0; h < 16; ++h) {
+      _gradX[h] = static_cast<float>(_grad(h, 1, 0, 0));
+      _gradY[h] = static_cast<float>(_grad(h, 0, 1, 0));
+    }
   }
 
   /**
@@ -94,7 +194,7 @@ public:
    * @return a value in the range [0, 1]
    */
   template <int octaves = 1>
-  double generate(double noiseX, double noiseY = 0, double noiseZ = 0) {
+  double generate(double noiseX, double noiseY = 0, double noiseZ = 0) const {
     static_assert(octaves > 0, "Must call PerlinNoise::generate with octaves > 0");
 
     double currentFreq = _frequency;
@@ -140,45 +240,123 @@ public:
     return std::max(0.,
                     std::min(1., result)); // clamp because there is no guarantee on output range
   }
+
+  /**
+   * @brief 2D noise in float: generate() with z = 0, less the z terms
+   * @return a value in the range [0, 1], bit for bit the same as generateRow gives
+   */
+  template <int octaves = 1>
+  float generate2D(float noiseX, float noiseY) const {
+    static_assert(octaves > 0, "Must call PerlinNoise::generate2D with octaves > 0");
+
+    float currentFreq = static_cast<float>(_frequency);
+    float currentAmp = 1;
+    float result = 0;
+    for (auto o = 0; o < octaves; ++o) {
+      result += _octave2D(noiseX * currentFreq, noiseY * currentFreq) * currentAmp;
+      currentAmp *= currentAmp * static_cast<float>(_persistence);
+      currentFreq *= static_cast<float>(_lacunarity);
+    }
+    return _finish(result);
+  }
+
+  /**
+   * @brief generate2D at (x0 + i, y) for every i in [0, count), into out
+   * @detail Runs four points at a time with SSE where it is available; the results don't depend
+   * on which points go through the vector path.
+   */
+  template <int octaves = 1>
+  void generateRow(int x0, int y, int count, float* out) const {
+    static_assert(octaves > 0, "Must call PerlinNoise::generateRow with octaves > 0");
+
+    int done = 0;
+#ifdef __SSE2__
+    done = count & ~3;
+    std::fill(out, out + done, 0.f);
+    float currentFreq = static_cast<float>(_frequency);
+    float currentAmp = 1;
+    for (auto o = 0; o < octaves; ++o) {
+      _octaveRowSse(x0, static_cast<float>(y) * currentFreq, currentFreq, currentAmp, done, out);
+      currentAmp *= currentAmp * static_cast<float>(_persistence);
+      currentFreq *= static_cast<float>(_lacunarity);
+    }
+    for (int i = 0; i < done; ++i) {
+      out[i] = _finish(out[i]);
+    }
+#endif
+    for (int i = done; i < count; ++i) {
+      out[i] = generate2D<octaves>(static_cast<float>(x0 + i), static_cast<float>(y));
+    }
+  }
 };
 
 class RegionGenerator {
-  constexpr static float world_bounds = world_size * tile_size;
   PerlinNoise _noise;
 
+  // the thresholds between tile types, compared in double as the maps have always been
+  static Tile _classify(double f) {
+    if (f < 0.3) {
+      return Tile::WATER;
+    } else if (f < 0.4) {
+      return Tile::SAND;
+    } else if (f > 0.88) {
+      return Tile::MOUNTAIN;
+    }
+    return Tile::GRASS;
+  }
+
+  // how far the float noise at p may be from generate<3>: its error grows with the coordinates,
+  // about 1e-8 per tile from the origin, and this allows ten times that
+  static float _noiseError(glm::ivec2 p) {
+    return 1e-5f + 1e-7f * static_cast<float>(std::max(std::abs(p.x), std::abs(p.y)));
+  }
+
 public:
   RegionGenerator(int seed = 42069) : _noise(seed) {
     _noise.frequency(1 / 30.).lacunarity(2.5);
   }
 
+  /// sets region up to generate its chunks from noise as they are first touched
   void generate(Region& region) {
-    auto& data = region._data;
+    const int size = region.size();
 
-    if (data.empty() || data[0].empty()) {
+    if (size < 3) {
       throw std::runtime_error("Bad region");
     }
 
-    for (size_t x = 0; x < data.size(); ++x) {
-      for (size_t y = 0; y < data[0].size(); ++y) {
-        double f = _noise.generate<3>(x, y);
+    region.setGenerator([generator = *this, size](glm::ivec2 origin, Region::Chunk& tiles) {
+      generator.fill(origin, size, tiles);
+    });
+  }
+
+  /**
+   * @brief The tiles of one chunk of a size by size map; safe to call from several threads at once
+   * @detail Noise comes from the float rows, and any value close enough to a threshold that
+   * their error could put it on the wrong side is worked out again with generate<3>, so a seed
+   * gives the same map as the double noise alone would.
+   */
+  void fill(glm::ivec2 origin, int size, Region::Chunk& tiles) const {
+    float row[Region::chunk_size];
+    for (int y = 0; y < Region::chunk_size; ++y) {
+      _noise.generateRow<3>(origin.x, origin.y + y, Region::chunk_size, row);
+      for (int x = 0; x < Region::chunk_size; ++x) {
+        const glm::ivec2 p = origin + glm::ivec2(x, y);
+        const float f = row[x];
+        const float error = _noiseError(p);
 
-        if (f < 0.3) {
-          data[x][y] = Tile::WATER;
-        } else if (f < 0.4) {
-          data[x][y] = Tile::SAND;
-        } else if (f > 0.88) {
-          data[x][y] = Tile::MOUNTAIN;
+        Tile& tile = tiles[y * Region::chunk_size + x];
+        if (std::abs(f - 0.3f) <= error || std::abs(f - 0.4f) <= error ||
+            std::abs(f - 0.88f) <= error) {
+          tile = _classify(_noise.generate<3>(p.x, p.y));
+        } else {
+          tile = _classify(f);
         }
-      }
-    }
 
-    // Ensure that the tiles in the middle of the screen (the one that
-    // enemies are pathfinding toward) is walkable
-    constexpr int xdir[] = {-1, 0, 1};
-    constexpr int ydir[] = {-1, 0, 1};
-    for (int x : xdir) {
-      for (int y : ydir) {
-        data[x + (data.size() / 2)][y + (data.size() / 2)] = Tile::GRASS;
+        // Ensure that the tiles in the middle of the screen (the one that
+        // enemies are pathfinding toward) is walkable
+        if (std::abs(p.x - size / 2) <= 1 && std::abs(p.y - size / 2) <= 1) {
+          tile = Tile::GRASS;
+        }
       }
     }
   }
@@ -0,0 +1,81 @@
+#include "Components.h"
+#include "Config.h"
+#include "Definitions.h"
+#include "EnemySpawner.h"
+#include "GameState.h"
+#include "World.h"
+
+#include "ECS/Manager.h"
+
+#include "Systems/BattleSystem.h"
+#include "Systems/MoveSystem.h"
+#include "Systems/ResourceSystem.h"
+#include "Systems/SpatialIndexSystem.h"
+#include "Systems/TargetingSystem.h"
+#include "Systems/UnitCollisionSystem.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * @brief Runs the game's simulation with no window, as fast as it will go
+ * @detail Usage: fortress-sim [ticks] [units] [seed] [size]. Places the base and a block of units
+ * around the middle of the map, lets the spawner send waves at them, and reports how many
+ * sim_step ticks ran per second of wall time.
+ */
+int main(int argc, char** argv) {
+  const long ticks = argc > 1 ? std::atol(argv[1]) : 9000;
+  const int unitCount = argc > 2 ? std::atoi(argv[2]) : 200;
+  const unsigned seed = argc > 3 ? static_cast<unsigned>(std::atol(argv[3])) : 0;
+  const int size = argc > 4 ? std::atoi(argv[4]) : default_world_size;
+
+  try {
+    loadDefinitionsFile("data/definitions.txt");
+  } catch (const std::runtime_error& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+
+  ResourceType resources = init_resource_bal;
+  bool debug = false;
+  World world(size, resources);
+  GameState gameState(world, resources, debug);
+
+  createComponentStores();
+  // the same order as Game, less the Systems that only take input or draw
+  ECS::Manager::addSystem(ECS::System::Ptr(new MoveSystem(gameState)));
+  ECS::Manager::addSystem(ECS::System::Ptr(new UnitCollisionSystem(gameState)));
+  ECS::Manager::addSystem(ECS::System::Ptr(new SpatialIndexSystem(gameState)));
+  ECS::Manager::addSystem(ECS::System::Ptr(new TargetingSystem(gameState)));
+  ECS::Manager::addSystem(ECS::System::Ptr(new BattleSystem(gameState)));
+  ECS::Manager::addSystem(ECS::System::Ptr(new ResourceSystem(gameState, resources)));
+
+  const glm::ivec2 center = world.centerCell();
+  world.addStructure({center.x, center.y + 1}, StructureType::BASE);
+
+  resources += unitCount * UnitProperties::of(UnitType::UNIT).cost;
+  const int side = static_cast<int>(std::ceil(std::sqrt(unitCount)));
+  for (int i = 0; i < unitCount; ++i) {
+    const glm::vec2 offset(i % side - side / 2, i / side - side / 2);
+    world.addUnit(centerOfTile(center) + offset * Unit::unit_size * 1.5f);
+  }
+
+  EnemySpawner spawner(world, seed);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (long tick = 0; tick < ticks; ++tick) {
+    ECS::Manager::update(sim_step);
+    spawner.update(sim_step);
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  std::cout << ticks << " ticks (" << ticks * sim_step << "s of game time) in "
+            << elapsed.count() << "s: " << ticks / elapsed.count() << " ticks/sec" << std::endl;
+  std::cout << world.units().size() << " units, " << world.enemies().size() << " enemies, "
+            << world.structures().size() << " structures left" << std::endl;
+
+  return 0;
+}
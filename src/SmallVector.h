@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+/**
+ * @brief A vector that keeps its first N elements inline and only allocates past that
+ * @detail Once the contents outgrow the inline buffer they all move to a heap vector, so the
+ * elements are always contiguous. clear() keeps the heap capacity, so a long list that is
+ * refilled doesn't allocate again.
+ *
+ * @tparam T A trivially copyable element type
+ * @tparam N How many elements fit without allocating
+ */
+template <typename T, std::size_t N>
+class SmallVector {
+  std::array<T, N> _inline{};
+  std::vector<T> _heap; // holds everything while _spilled
+  std::size_t _size = 0; // of _inline, while not _spilled
+  bool _spilled = false;
+
+  void _spill(std::size_t capacity) {
+    _heap.clear();
+    _heap.reserve(std::max(capacity, 2 * N));
+    _heap.insert(_heap.end(), _inline.begin(), _inline.begin() + _size);
+    _spilled = true;
+  }
+
+public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  SmallVector() = default;
+
+  SmallVector(std::initializer_list<T> values) {
+    assign(values.begin(), values.end());
+  }
+
+  T* data() {
+    return _spilled ? _heap.data() : _inline.data();
+  }
+
+  const T* data() const {
+    return _spilled ? _heap.data() : _inline.data();
+  }
+
+  std::size_t size() const {
+    return _spilled ? _heap.size() : _size;
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  iterator begin() {
+    return data();
+  }
+
+  iterator end() {
+    return data() + size();
+  }
+
+  const_iterator begin() const {
+    return data();
+  }
+
+  const_iterator end() const {
+    return data() + size();
+  }
+
+  T& operator[](std::size_t i) {
+    return data()[i];
+  }
+
+  const T& operator[](std::size_t i) const {
+    return data()[i];
+  }
+
+  T& front() {
+    return data()[0];
+  }
+
+  const T& front() const {
+    return data()[0];
+  }
+
+  T& back() {
+    return data()[size() - 1];
+  }
+
+  const T& back() const {
+    return data()[size() - 1];
+  }
+
+  void push_back(const T& value) {
+    if (not _spilled && _size == N) {
+      _spill(N + 1);
+    }
+    if (_spilled) {
+      _heap.push_back(value);
+    } else {
+      _inline[_size++] = value;
+    }
+  }
+
+  void pop_back() {
+    if (_spilled) {
+      _heap.pop_back();
+    } else {
+      --_size;
+    }
+  }
+
+  void clear() {
+    _heap.clear();
+    _size = 0;
+    _spilled = false;
+  }
+
+  /// replaces the contents with [first, last), which must not point into this vector
+  template <typename It>
+  void assign(It first, It last) {
+    clear();
+    append(first, last);
+  }
+
+  /// adds [first, last) to the end, which must not point into this vector
+  template <typename It>
+  void append(It first, It last) {
+    const std::size_t count = size() + std::distance(first, last);
+    if (not _spilled && count > N) {
+      _spill(count);
+    }
+    if (_spilled) {
+      _heap.insert(_heap.end(), first, last);
+    } else {
+      _size = std::copy(first, last, _inline.begin() + _size) - _inline.begin();
+    }
+  }
+
+  bool operator==(const SmallVector& o) const {
+    return size() == o.size() && std::equal(begin(), end(), o.begin());
+  }
+
+  bool operator!=(const SmallVector& o) const {
+    return not(*this == o);
+  }
+};
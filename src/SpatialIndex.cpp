@@ -0,0 +1,102 @@
+#include "SpatialIndex.h"
+
+#include <algorithm>
+
+constexpr int SpatialIndex::bucket_size;
+
+SpatialIndex::SpatialIndex(int worldSize)
+    : _bucketsPerSide(std::max(1, (worldSize + bucket_size - 1) / bucket_size)),
+      _buckets(static_cast<std::size_t>(_bucketsPerSide) * _bucketsPerSide) {}
+
+void SpatialIndex::insert(ECS::Entity entity, glm::vec2 pos, Faction faction) {
+  remove(entity);
+
+  const std::size_t bucket = _indexOf(_bucketOf(pos));
+  _slots[entity] = Slot{bucket, _buckets[bucket].size()};
+  _buckets[bucket].push_back(Item{entity, pos, faction});
+}
+
+bool SpatialIndex::move(ECS::Entity entity, glm::vec2 pos) {
+  auto it = _slots.find(entity);
+  if (it == _slots.end()) {
+    return false;
+  }
+
+  const Slot slot = it->second;
+  Item& item = _buckets[slot.bucket][slot.index];
+  item.pos = pos;
+
+  const std::size_t bucket = _indexOf(_bucketOf(pos));
+  if (bucket != slot.bucket) {
+    const Item moved = item;
+    _erase(slot);
+    it->second = Slot{bucket, _buckets[bucket].size()};
+    _buckets[bucket].push_back(moved);
+    return true;
+  }
+  return false;
+}
+
+bool SpatialIndex::remove(ECS::Entity entity) {
+  auto it = _slots.find(entity);
+  if (it == _slots.end()) {
+    return false;
+  }
+
+  _erase(it->second);
+  _slots.erase(it);
+  return true;
+}
+
+void SpatialIndex::clear() {
+  for (auto& bucket : _buckets) {
+    bucket.clear();
+  }
+  _slots.clear();
+}
+
+ECS::Entity SpatialIndex::nearest(glm::vec2 center, float maxRadius, Faction mask) const {
+  ECS::Entity result = ECS::InvalidEntityId;
+  float best = maxRadius;
+
+  // search rings of buckets outward; everything in ring r + 1 is at least r buckets away
+  const glm::ivec2 middle = _bucketOf(center);
+  const float bucketExtent = bucket_size * tile_size;
+  for (int r = 0; r < _bucketsPerSide; ++r) {
+    if ((r - 1) * bucketExtent > best) {
+      break;
+    }
+
+    for (int y = middle.y - r; y <= middle.y + r; ++y) {
+      if (y < 0 || y >= _bucketsPerSide) {
+        continue;
+      }
+      // the first and last rows of the ring are whole, the rest only have their two ends
+      const int step = (y == middle.y - r || y == middle.y + r) ? 1 : std::max(2 * r, 1);
+      for (int x = middle.x - r; x <= middle.x + r; x += step) {
+        if (x < 0 || x >= _bucketsPerSide) {
+          continue;
+        }
+        for (const Item& item : _buckets[_indexOf({x, y})]) {
+          const float d = glm::distance(item.pos, center);
+          if (inMask(mask, item.faction) && d <= best) {
+            best = d;
+            result = item.entity;
+          }
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
+void SpatialIndex::_erase(Slot slot) {
+  // swap with the bucket's last item so removal doesn't shift the rest
+  std::vector<Item>& bucket = _buckets[slot.bucket];
+  if (slot.index + 1 != bucket.size()) {
+    bucket[slot.index] = bucket.back();
+    _slots[bucket[slot.index].entity].index = slot.index;
+  }
+  bucket.pop_back();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Config.h"
+#include "ECS/Entity.h"
+#include "Faction.h"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A uniform grid of buckets over the world for finding entities near a point
+ * @detail Each entity sits in the bucket under its position, which is a square of bucket_size
+ * tiles, and carries its Faction so queries can skip the sides they don't care about. Positions
+ * off the world are kept in the nearest edge bucket. Moving within a bucket only updates the
+ * stored position.
+ */
+class SpatialIndex {
+public:
+  static constexpr int bucket_size = 4; // in tiles
+
+  struct Item {
+    ECS::Entity entity;
+    glm::vec2 pos;
+    Faction faction;
+  };
+
+private:
+  struct Slot {
+    std::size_t bucket;
+    std::size_t index;
+  };
+
+  int _bucketsPerSide;
+  std::vector<std::vector<Item>> _buckets;
+  std::unordered_map<ECS::Entity, Slot> _slots;
+
+  glm::ivec2 _bucketOf(glm::vec2 pos) const {
+    const glm::ivec2 b(glm::floor(pos / (bucket_size * tile_size)));
+    return glm::clamp(b, glm::ivec2(0), glm::ivec2(_bucketsPerSide - 1));
+  }
+
+  std::size_t _indexOf(glm::ivec2 b) const {
+    return static_cast<std::size_t>(b.y) * _bucketsPerSide + b.x;
+  }
+
+  void _erase(Slot slot);
+
+public:
+  explicit SpatialIndex(int worldSize = default_world_size);
+
+  void insert(ECS::Entity entity, glm::vec2 pos, Faction faction);
+  /// updates where an indexed entity is; entities that aren't indexed are ignored
+  /// @return whether the entity changed buckets
+  bool move(ECS::Entity entity, glm::vec2 pos);
+  bool remove(ECS::Entity entity);
+
+  bool contains(ECS::Entity entity) const {
+    return _slots.count(entity) > 0;
+  }
+
+  std::size_t size() const {
+    return _slots.size();
+  }
+
+  void clear();
+
+  /// calls fn(const Item&) for every entity of a faction in mask inside the box [lo, hi]
+  template <typename F>
+  void queryBox(glm::vec2 lo, glm::vec2 hi, Faction mask, F&& fn) const {
+    const glm::ivec2 first = _bucketOf(lo), last = _bucketOf(hi);
+    for (int y = first.y; y <= last.y; ++y) {
+      for (int x = first.x; x <= last.x; ++x) {
+        for (const Item& item : _buckets[_indexOf({x, y})]) {
+          if (inMask(mask, item.faction) && item.pos.x >= lo.x && item.pos.y >= lo.y &&
+              item.pos.x <= hi.x && item.pos.y <= hi.y) {
+            fn(item);
+          }
+        }
+      }
+    }
+  }
+
+  /// calls fn(const Item&) for every entity of a faction in mask within radius of center
+  template <typename F>
+  void queryRadius(glm::vec2 center, float radius, Faction mask, F&& fn) const {
+    queryBox(center - radius, center + radius, mask, [&](const Item& item) {
+      if (glm::distance(item.pos, center) <= radius) {
+        fn(item);
+      }
+    });
+  }
+
+  /// the closest entity of a faction in mask within maxRadius, or ECS::InvalidEntityId
+  ECS::Entity nearest(glm::vec2 center, float maxRadius, Faction mask) const;
+};
@@ -1,37 +1,47 @@
 #include "Structure.h"
-#include "Game.h"
+#include "Tile.h"
 
 #include "World.h"
 
+namespace {
+
 // clang-format off
-const std::unordered_map<StructureType, const StructureData> StructureProperties::_data{
-    {StructureType::NONE, StructureData{
+constexpr std::array<StructureData, structure_type_count> structure_defaults{{
+    /* NONE */ StructureData{
         .health = 0,
         .resourceSpeed = 0,
         .cost = 0,
         .texOffset = 0
-    }},
-    {StructureType::DEFAULT, StructureData{
+    },
+    /* DEFAULT */ StructureData{
         .health = 500,
         .resourceSpeed = 1.0f,
         .cost = 100.f,
         .texOffset = 2
-    }},
-    {StructureType::BASE, StructureData{
+    },
+    /* BASE */ StructureData{
         .health = 1000,
         .resourceSpeed = 3.0f,
         .cost = 0.f,
         .texOffset = 6
-    }},
-    {StructureType::WALL, StructureData{
+    },
+    /* WALL */ StructureData{
         .health = 500,
         .resourceSpeed = 0.f,
         .cost = 25.f,
         .texOffset = 7
-    }}
-};
+    }
+}};
 // clang-format on
 
+} // namespace
+
+std::array<StructureData, structure_type_count> StructureProperties::_data = structure_defaults;
+
+void StructureProperties::reset() {
+  _data = structure_defaults;
+}
+
 Structure::Structure(glm::vec2 pos, World& world, StructureType t)
     : id(ECS::Manager::createEntity()) {
   auto& prop = StructureProperties::of(t);
@@ -45,6 +55,8 @@ Structure::Structure(glm::vec2 pos, World& world, StructureType t)
   ECS::Manager::addComponent<HealthComponent>(id, HealthComponent(health));
   ECS::Manager::addComponent<ResourceComponent>(id, ResourceComponent(resourceSpeed));
   ECS::Manager::addComponent<LightComponent>(id, LightComponent({1.f, 0.95f, 0.85f, 1.f}, 3.f));
+  ECS::Manager::addComponent<FactionComponent>(id, FactionComponent(Faction::STRUCTURE));
+  ECS::Manager::addComponent<StructureComponent>(id, StructureComponent(t));
 
   ECS::Manager::registerEntity(id);
 }
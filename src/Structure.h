@@ -5,22 +5,14 @@
 #include "Components.h"
 
 #include "Config.h"
-#include "Graphics.h"
 
 class World;
 
-enum class StructureType { NONE, DEFAULT, BASE, WALL };
-
-namespace std {
-
-template <>
-struct hash<StructureType> {
-  size_t operator()(const StructureType& t) const {
-    return std::hash<int>()(static_cast<int>(t));
-  }
-};
+#include <array>
+#include <cstddef>
 
-} // namespace std
+enum class StructureType { NONE, DEFAULT, BASE, WALL };
+constexpr std::size_t structure_type_count = static_cast<std::size_t>(StructureType::WALL) + 1;
 
 struct StructureData {
   HealthValue health;
@@ -29,13 +21,24 @@ struct StructureData {
   int texOffset;
 };
 
+/**
+ * @brief Every StructureData, indexed by StructureType
+ * @detail Starts out as the built-in table and can be changed at startup by loadDefinitions.
+ */
 class StructureProperties {
-  static const std::unordered_map<StructureType, const StructureData> _data;
+  static std::array<StructureData, structure_type_count> _data;
 
 public:
   static const StructureData& of(StructureType t) {
-    return _data.at(t);
+    return _data[static_cast<std::size_t>(t)];
+  }
+
+  static void set(StructureType t, const StructureData& data) {
+    _data[static_cast<std::size_t>(t)] = data;
   }
+
+  /// back to the built-in table
+  static void reset();
 };
 
 class Structure {
@@ -0,0 +1,109 @@
+#include "Sweep.h"
+#include "Config.h"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// contacts are left this far apart so the next sweep doesn't start out touching
+constexpr float skin = 1e-3f;
+
+/// when a point moving from p by d first enters box [lo, hi] grown by r, as a fraction of d
+bool timeOfImpact(glm::vec2 p, glm::vec2 d, glm::vec2 lo, glm::vec2 hi, float r, float& t,
+                  glm::vec2& normal) {
+  // slab test against the box grown by r on every side
+  float enter = -std::numeric_limits<float>::max(), exit = std::numeric_limits<float>::max();
+  glm::vec2 enterNormal(0, 0);
+  for (int a = 0; a < 2; ++a) {
+    const float low = lo[a] - r, high = hi[a] + r;
+    if (std::abs(d[a]) < 1e-9f) {
+      if (p[a] <= low || p[a] >= high) {
+        return false;
+      }
+      continue;
+    }
+
+    float t0 = (low - p[a]) / d[a], t1 = (high - p[a]) / d[a];
+    if (t0 > t1) {
+      std::swap(t0, t1);
+    }
+    if (t0 > enter) {
+      enter = t0;
+      enterNormal = glm::vec2(0, 0);
+      enterNormal[a] = d[a] > 0 ? -1 : 1;
+    }
+    exit = std::min(exit, t1);
+  }
+  if (enter > exit || enter > 1 || exit < 0) { // missed or too far
+    return false;
+  }
+
+  // entering through a corner of the grown box only counts if it hits the rounded corner, and
+  // a start inside the grown box is only clear of the tile in one of those corners
+  const glm::vec2 at = p + d * std::max(enter, 0.f);
+  const bool outsideX = at.x < lo.x || at.x > hi.x, outsideY = at.y < lo.y || at.y > hi.y;
+  if (outsideX && outsideY) {
+    const glm::vec2 corner(at.x < lo.x ? lo.x : hi.x, at.y < lo.y ? lo.y : hi.y);
+    const glm::vec2 m = p - corner;
+    const float a = glm::dot(d, d), b = glm::dot(m, d), c = glm::dot(m, m) - r * r;
+    const float discriminant = b * b - a * c;
+    if (c < 0 || discriminant < 0) {
+      return false;
+    }
+    t = (-b - std::sqrt(discriminant)) / a;
+    if (t < 0 || t > 1) {
+      return false;
+    }
+    normal = glm::normalize(p + d * t - corner);
+    return true;
+  }
+  if (enter < 0) { // already overlapping
+    return false;
+  }
+
+  t = enter;
+  normal = enterNormal;
+  return true;
+}
+
+} // namespace
+
+Sweep sweepCircle(const BitGrid& walkable, glm::vec2 from, glm::vec2 delta, float radius) {
+  Sweep result{from + delta, glm::vec2(0, 0), glm::vec2(0, 0), false};
+  if (delta == glm::vec2(0, 0)) {
+    return result;
+  }
+
+  // every tile the circle's bounding box passes over
+  const glm::ivec2 lo(glm::floor((glm::min(from, from + delta) - radius) / tile_size));
+  const glm::ivec2 hi(glm::floor((glm::max(from, from + delta) + radius) / tile_size));
+
+  float first = 1;
+  for (int x = lo.x; x <= hi.x; ++x) {
+    for (int y = lo.y; y <= hi.y; ++y) {
+      if (walkable.get({x, y})) {
+        continue;
+      }
+      const glm::vec2 tileLo = glm::vec2(x, y) * tile_size;
+      float t;
+      glm::vec2 normal;
+      if (timeOfImpact(from, delta, tileLo, tileLo + tile_size, radius, t, normal) &&
+          t <= first) {
+        first = t;
+        result.normal = normal;
+        result.hit = true;
+      }
+    }
+  }
+
+  if (result.hit) {
+    const glm::vec2 rest = delta * (1 - first);
+    result.contact = from + delta * first + result.normal * skin;
+    result.slide = rest - result.normal * glm::dot(rest, result.normal);
+  }
+  return result;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "BitGrid.h"
+
+#include <glm/vec2.hpp>
+
+struct Sweep {
+  glm::vec2 contact; // where the circle's center stops
+  glm::vec2 normal;  // of the surface it stopped against, pointing back at it; zero if no hit
+  glm::vec2 slide;   // what is left of the displacement, projected along that surface
+  bool hit;
+};
+
+/**
+ * @brief Moves a circle across the tile grid until it touches an unwalkable tile
+ * @detail Finds the earliest time of impact against every blocked tile near the motion in one
+ * pass, treating each tile as a box rounded by the radius, so no motion is ever split into
+ * steps and nothing tunnels at low frame rates. Tiles off the grid count as blocked. A circle
+ * that already overlaps a tile isn't stopped by it; see DistanceField::pushOut.
+ *
+ * @param from The circle's center, in world coordinates
+ * @param delta The displacement to try
+ *
+ * @return Where the circle stopped, and the slide vector to continue with if it hit something
+ */
+Sweep sweepCircle(const BitGrid& walkable, glm::vec2 from, glm::vec2 delta, float radius);
@@ -4,6 +4,8 @@
 #include "Systems/HealthBarSystem.h"
 #include "Systems/MoveSystem.h"
 #include "Systems/ResourceSystem.h"
+#include "Systems/SpatialIndexSystem.h"
+#include "Systems/TargetingSystem.h"
 #include "Systems/UnitCollisionSystem.h"
 #include "Systems/UnitCommandSystem.h"
 #include "Systems/UnitSelectionSystem.h"
@@ -1,92 +1,63 @@
 #pragma once
 
+#include "../BattleEvents.h"
 #include "../Components.h"
 #include "../ECS/System.h"
-#include "../Events.h"
 #include "../GameState.h"
 #include "../World.h"
 
+#include <vector>
+
 /**
  * @brief Facilitates battle between Units and Enemies
- *
+ * @detail Fights whatever TargetingSystem picked, in phases. First every awake fighter decides
+ * whether it fires this step and adds a hit to a buffer, changing nothing but its own state.
+ * Then every hit is applied in one pass, and everything brought to 0 health is removed together
+ * at the end. So who fires first within a step makes no difference, and the first phase could
+ * be split across threads. Entities without a target sleep here until it finds them one or they
+ * are attacked, so idle armies cost nothing here.
  */
 class BattleSystem : public ECS::System {
-  void _performAttack(const ECS::Entity entity, const ECS::Entity target) {
-    if (entity == ECS::InvalidEntityId || target == ECS::InvalidEntityId) {
-      return;
-    }
-
-    auto& targetHealth = ECS::Manager::getComponent<HealthComponent>(target).health;
-    auto entityStrength = ECS::Manager::getComponent<AttackComponent>(entity).strength;
-
-    // Augment the target's health according to the attack strength
-    targetHealth -= entityStrength;
-
-    // Reset the attack timer so we will attack again after attackCooldown
-    ECS::Manager::getComponent<AttackComponent>(entity).attackTimer = 0.f;
-
-    glm::vec2 pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
-    glm::vec2 tpos = ECS::Manager::getComponent<TransformComponent>(target).pos;
-    _gameState._bulletParticles.add(BulletParticle(pos, tpos, 20));
-
-    if (targetHealth <= 0 && ECS::Manager::hasComponent<ResourceComponent>(target)) {
-      auto& world = ECS::Manager::getComponent<TransformComponent>(target).world;
-      world.removeStructure(target); // delete structure
-    }
-  }
+  struct Hit {
+    ECS::Entity attacker;
+    ECS::Entity target;
+    StrengthValue damage;
+  };
+
+  std::vector<Hit> _hits;          // fired this step
+  std::vector<ECS::Entity> _dying; // brought to 0 health this step
+
+  void _applyHits() {
+    for (const Hit& hit : _hits) {
+      auto& targetHealth = ECS::Manager::getComponent<HealthComponent>(hit.target).health;
+      if (targetHealth <= 0) {
+        continue; // already dying; the rest of the hits this step are spent on a corpse
+      }
 
-  void _die(const ECS::Entity entity) {
-    auto& pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
-    auto& world = ECS::Manager::getComponent<TransformComponent>(entity).world;
+      targetHealth -= hit.damage;
+      if (targetHealth <= 0) {
+        _dying.push_back(hit.target);
+      }
+      ECS::Manager::wake(hit.target); // so it can fight back
 
-    if (ECS::Manager::hasComponent<CommandableComponent>(entity)) {
-      world.removeUnit(entity); // delete unit
-    } else if (ECS::Manager::hasComponent<MotionComponent>(entity)) {
-      world.removeEnemy(entity); // delete enemy
+      glm::vec2 pos = ECS::Manager::getComponent<TransformComponent>(hit.attacker).pos;
+      glm::vec2 tpos = ECS::Manager::getComponent<TransformComponent>(hit.target).pos;
+      ECS::EventManager::event(new ShotEvent(pos, tpos));
     }
-
-    _gameState._deathParticles.add(DeathParticle(pos));
+    _hits.clear();
   }
 
-  void _scanForHostiles(const ECS::Entity entity) {
-    auto& pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
-    auto& attack = ECS::Manager::getComponent<AttackComponent>(entity);
-
-    if (ECS::Manager::hasComponent<CommandableComponent>(entity)) { // entity is a Unit
-      for (auto& hostile : _gameState.enemies) {
-        auto& hostilePos = ECS::Manager::getComponent<TransformComponent>(hostile.id).pos;
-        auto dist = glm::distance(pos, hostilePos);
-
-        if (dist < attack.attackRange) {
-          attack.target = hostile.id;
-          attack.battling = true;
-          return;
-        }
-      }
-    } else { // entity is an Enemy
-      for (auto& hostile : _gameState.units) {
-        auto& hostilePos = ECS::Manager::getComponent<TransformComponent>(hostile.id).pos;
-        auto dist = glm::distance(pos, hostilePos);
-
-        if (dist < attack.attackRange) {
-          attack.target = hostile.id;
-          return;
-        }
-      }
-      for (auto& structure : _gameState.structures) {
-        auto& structurePos = ECS::Manager::getComponent<TransformComponent>(structure.id).pos;
-        auto dist = glm::distance(pos, structurePos);
-
-        if (dist < attack.attackRange) {
-          attack.target = structure.id;
-          return;
-        }
+  void _despawnDying() {
+    World& world = _gameState.world;
+    for (ECS::Entity entity : _dying) {
+      // structures just go; units and enemies leave a burst behind
+      if (world.roster().factionOf(entity) != Faction::STRUCTURE) {
+        const glm::vec2 pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
+        ECS::EventManager::event(new DeathEvent(pos));
       }
     }
-
-    attack.target = ECS::InvalidEntityId;
-    attack.battling = false;
-    attack.attackTimer = attack.attackCooldown;
+    world.remove(_dying); // all at once, so movers repath once however many structures fell
+    _dying.clear();
   }
 
 public:
@@ -99,13 +70,17 @@ public:
     setRequiredComponents(std::move(requiredComponents));
   }
 
-  void updateEntity(float dt, ECS::Entity entity) override {
-    if (not ECS::Manager::hasEntity(entity)) {
-      return;
-    }
+  std::size_t update(float dt) override {
+    const std::size_t result = ECS::System::update(dt);
+    _applyHits();
+    _despawnDying();
+    return result;
+  }
 
-    if (ECS::Manager::getComponent<HealthComponent>(entity).health <= 0) {
-      _die(entity);
+  /// decides whether entity fires this step; changes nothing but entity's own attack state
+  void updateEntity(float dt, ECS::Entity entity) override {
+    if (not ECS::Manager::hasEntity(entity) ||
+        ECS::Manager::getComponent<HealthComponent>(entity).health <= 0) {
       return;
     }
 
@@ -117,7 +92,15 @@ public:
     }
 
     if (target == ECS::InvalidEntityId) {
-      _scanForHostiles(entity);
+      auto& attack = ECS::Manager::getComponent<AttackComponent>(entity);
+      const bool hadTarget = attack.target != ECS::InvalidEntityId;
+      attack.target = ECS::InvalidEntityId;
+      attack.battling = false;
+      attack.attackTimer = attack.attackCooldown;
+      if (hadTarget) {
+        ECS::Manager::wake(entity); // so TargetingSystem looks for another
+      }
+      sleep(entity);
       return;
     }
 
@@ -133,10 +116,12 @@ public:
       attack.attackTimer += dt;
 
       if (attack.attackTimer > attack.attackCooldown) {
-        _performAttack(entity, target);
+        // Reset the attack timer so we will attack again after attackCooldown
+        attack.attackTimer = 0.f;
+        _hits.push_back(Hit{entity, target, attack.strength});
       }
     } else { // Reset the timer so we attack immediately on engaging
-      attack.attackTimer = ECS::Manager::getComponent<AttackComponent>(entity).attackCooldown;
+      attack.attackTimer = attack.attackCooldown;
     }
   }
 };
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../Components.h"
+#include "../ECS/System.h"
+#include "../GameState.h"
+#include "../World.h"
+
+/**
+ * @brief Keeps the World's FactionRoster in step with every Entity that has a FactionComponent
+ * @detail An Entity joins its faction's array when it registers with the Manager and leaves
+ * once it is unregistered, so the World never has to add or remove anything by hand. Nothing is
+ * done per update. GameState installs one for its World.
+ */
+class FactionRosterSystem : public ECS::System {
+public:
+  FactionRosterSystem(GameState& gameState) : ECS::System(gameState) {
+    ECS::ComponentTypeSet requiredComponents;
+    requiredComponents.insert(FactionComponent::type);
+
+    setRequiredComponents(std::move(requiredComponents));
+  }
+
+  bool registerEntity(ECS::Entity entity) override {
+    const Faction faction = ECS::Manager::getComponent<FactionComponent>(entity).faction;
+    _gameState.world._roster.add(entity, faction);
+    return ECS::System::registerEntity(entity);
+  }
+
+  std::size_t unregisterEntity(ECS::Entity entity) override {
+    _gameState.world._roster.remove(entity);
+    return ECS::System::unregisterEntity(entity);
+  }
+
+  std::size_t update(float) override {
+    return 0;
+  }
+
+  void updateEntity(float, ECS::Entity) override {}
+};
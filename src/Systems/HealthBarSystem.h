@@ -3,10 +3,16 @@
 #include "../Components.h"
 #include "../ECS/System.h"
 #include "../GameState.h"
+#include "../Graphics.h"
 
+/**
+ * @brief Draws a bar over everything that has lost health
+ */
 class HealthBarSystem : public ECS::System {
+  View& _view;
+
 public:
-  HealthBarSystem(GameState& gameState) : ECS::System(gameState) {
+  HealthBarSystem(GameState& gameState, View& view) : ECS::System(gameState), _view(view) {
     ECS::ComponentTypeSet requiredComponents;
     requiredComponents.insert(TransformComponent::type);
     requiredComponents.insert(HealthComponent::type);
@@ -14,18 +20,29 @@ public:
     setRequiredComponents(std::move(requiredComponents));
   }
 
-  virtual void updateEntity(float dt, ECS::Entity entity) override {
+  std::size_t update(float dt) override {
+    return 0; // nothing to simulate
+  }
+
+  virtual void updateEntity(float dt, ECS::Entity entity) override {}
+
+  void render(float alpha) override {
     const glm::vec2 offset(0, 0.8);
     const glm::vec2 maxSize(1.0, 0.1);
     constexpr float borderSize = 0.1;
-    auto& pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
-    auto& healthComponent = ECS::Manager::getComponent<HealthComponent>(entity);
 
-    const float f = static_cast<float>(healthComponent.health) / healthComponent.maxHealth;
-    glm::vec2 size(maxSize.x * f, maxSize.y);
+    RectangleBatch healthBar;
+    for (ECS::Entity entity : entities()) {
+      const glm::vec2 pos =
+          ECS::Manager::getComponent<TransformComponent>(entity).renderPos(alpha);
+      auto& healthComponent = ECS::Manager::getComponent<HealthComponent>(entity);
+
+      const float f = static_cast<float>(healthComponent.health) / healthComponent.maxHealth;
+      glm::vec2 size(maxSize.x * f, maxSize.y);
 
-    if (f < 1.f) {
-      RectangleBatch healthBar;
+      if (f >= 1.f) {
+        continue;
+      }
       healthBar.add()
           .color({.1, .1, .1, 0.5f})
           .position(pos + offset)
@@ -34,7 +51,7 @@ public:
           .color({1 - f, f, 0, 0.75f})
           .position(pos + offset - glm::vec2((1 - size.x) / 2.f, 0))
           .size(size);
-      healthBar.draw(_gameState._view);
     }
+    healthBar.draw(_view);
   }
-};
\ No newline at end of file
+};
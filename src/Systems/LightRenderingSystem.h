@@ -10,8 +10,12 @@ class LightRenderingSystem : public ECS::System {
   CircleBatch _testCircles;
   LightBatch _lights;
 
+  View& _view;
+  RenderWindow& _window;
+
 public:
-  LightRenderingSystem(GameState& gameState) : ECS::System(gameState) {
+  LightRenderingSystem(GameState& gameState, View& view, RenderWindow& window)
+      : ECS::System(gameState), _view(view), _window(window) {
     ECS::ComponentTypeSet requiredComponents;
     requiredComponents.insert(TransformComponent::type);
     requiredComponents.insert(LightComponent::type);
@@ -20,26 +24,32 @@ public:
   }
 
   std::size_t update(float dt) override {
+    return 0; // nothing to simulate
+  }
+
+  void updateEntity(float dt, ECS::Entity entity) override {}
+
+  void render(float alpha) override {
     _lights.instances.clear();
     _testCircles.instances.clear();
-    auto result = ECS::System::update(dt);
-    _lights.draw(_gameState._view, _gameState._window, _gameState.debug);
-    if (_gameState.debug) {
-      _testCircles.draw(_gameState._view);
+
+    for (ECS::Entity entity : entities()) {
+      auto& light = ECS::Manager::getComponent<LightComponent>(entity);
+      const glm::vec2 pos =
+          ECS::Manager::getComponent<TransformComponent>(entity).renderPos(alpha);
+      _testCircles.add()
+        .position(pos)
+        .size({0.2, 0.2})
+        .color({1, 0, 0, 1});
+      _lights.add()
+        .position(pos)
+        .color(light.color)
+        .intensity(light.intensity);
     }
-    return result;
-  }
 
-  void updateEntity(float dt, ECS::Entity entity) override {
-    auto& light = ECS::Manager::getComponent<LightComponent>(entity);
-    auto& pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
-    _testCircles.add()
-      .position(pos)
-      .size({0.2, 0.2})
-      .color({1, 0, 0, 1});
-    _lights.add()
-      .position(pos)
-      .color(light.color)
-      .intensity(light.intensity);
+    _lights.draw(_view, _window, _gameState.debug);
+    if (_gameState.debug) {
+      _testCircles.draw(_view);
+    }
   }
 };
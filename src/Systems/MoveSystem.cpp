@@ -1,137 +1,99 @@
 #include "MoveSystem.h"
 
-#include "../Game.h"
 #include "../Tile.h"
+#include "../World.h"
 
 #include "../GlmHashes.h"
 #include "../Path.h"
 
 #include <unordered_set>
 
-bool MoveSystem::tileVisible(Region& region, glm::ivec2 tileCoord, glm::vec2 from) {
-  auto raycast = [&region](glm::vec2 source, glm::vec2 target) -> bool {
-    auto path = target - source;
-    auto l = glm::length(path);
-    auto dir = glm::normalize(path);
-    for (float k = 0; k < l; k += 0.2 /* <- precision */) {
-      glm::ivec2 p = Game::mapCoordsToTile(source + dir * k);
-      if (not TileProperties::of(region[p.x][p.y]).walkable || region.structureAt(p)) {
-        return false;
-      }
-    }
-    return true;
-  };
-
-  auto seesPoint = [&raycast, &region, &from](glm::vec2 target) -> bool {
-    return raycast(from, target);
-  };
-
-  auto valid = [](glm::ivec2 p) -> bool {
-    return 0 <= p.x && 0 <= p.y && p.x < world_size && p.y < world_size;
-  };
-
-  glm::vec2 t;
-  glm::ivec2 curr;
-
-  curr = tileCoord;
-  t = {curr.x, curr.y};
-  if (valid(curr) && not seesPoint(t)) {
-    return false;
-  }
-
-  curr = tileCoord + glm::ivec2(0, 1);
-  t = {curr.x, curr.y};
-  if (valid(curr) && not seesPoint(t)) {
-    return false;
-  }
-
-  curr = tileCoord + glm::ivec2(1, 0);
-  t = {curr.x, curr.y};
-  if (valid(curr) && not seesPoint(t)) {
-    return false;
-  }
-
-  curr = tileCoord + glm::ivec2(0, 1);
-  t = {curr.x, curr.y};
-  if (valid(curr) && not seesPoint(t)) {
-    return false;
-  }
-
-  return true;
-}
-
 void MoveSystem::recomputePath(ECS::Entity entity) {
   auto& pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
-  auto& region = ECS::Manager::getComponent<TransformComponent>(entity).world.region();
+  auto& world = ECS::Manager::getComponent<TransformComponent>(entity).world;
   auto& motion = ECS::Manager::getComponent<MotionComponent>(entity);
 
-  glm::ivec2 curr_cell = Game::mapCoordsToTile(pos);
-  glm::ivec2 target_cell = Game::mapCoordsToTile(motion.target);
+  glm::ivec2 curr_cell = mapCoordsToTile(pos);
+  glm::ivec2 target_cell = mapCoordsToTile(motion.target);
 
-  auto path = findPath(region, curr_cell, target_cell);
+  auto path = world.pathCache().find(world.region(), curr_cell, target_cell, clearance);
   if (path.empty()) { // pathfinding failed
     motion.hasTarget = false;
     return;
   }
 
   motion.path = std::move(path);
-
-  auto simplifyPath = [&](Path& path) {
-    if (path.size() == 0) return Path();
-
-    Path simplifiedPath;
-    // simplifiedPath.push_back(path[0]);
-
-    uint last = 0;
-    uint index = 1;
-    while (index < path.size()) {
-      if (tileVisible(region, path[index], path[last])) {
-        ++index;
-      } else {
-        last = index - 1;                     // update last visible point
-        simplifiedPath.push_back(path[last]); // emit the point
-        // ++index; // TODO: remove; ensures algorithm progression but produces extra steps
-        // might need to adjust tileVisible to avoid infinite loop here.
-      }
-    }
-    simplifiedPath.push_back(path.back());
-    return simplifiedPath;
-  };
-  motion.path = simplifyPath(motion.path);
+  motion.waypoint = 0;
   motion.oldPosition = pos;
 }
 
+std::size_t MoveSystem::update(float dt) {
+  _kinematics.clear();
+  _movers.clear();
+
+  auto result = ECS::System::update(dt);
+
+  steer(_kinematics, Unit::unit_size, dt);
+  _writeBack();
+
+  return result;
+}
+
 void MoveSystem::updateEntity(float dt, ECS::Entity entity) {
-  auto& pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
-  auto& rot = ECS::Manager::getComponent<TransformComponent>(entity).rot;
+  auto& transform = ECS::Manager::getComponent<TransformComponent>(entity);
   auto& motion = ECS::Manager::getComponent<MotionComponent>(entity);
 
   if (not motion.hasTarget) {
+    sleep(entity); // until it is given an order
     return;
   }
 
-  if (motion.path.empty()) {
+  if (not motion.onPath()) {
     recomputePath(entity);
+    if (not motion.hasTarget) {
+      sleep(entity);
+      return;
+    }
   }
 
-  glm::vec2 targetPos = Game::centerOfTile(motion.path.front());
-  float dist = glm::distance(pos, targetPos);
-
-  glm::vec2 pathDir = targetPos - motion.oldPosition;
-  float dot = glm::dot(pathDir, targetPos - pos);
-  if (dist < Unit::unit_size || dot < 0) {
-    // advance to next waypoint
-    motion.oldPosition = pos;
-    motion.path.pop_front();
-    if (motion.path.empty()) {
-      motion.hasTarget = false;
+  // TODO: raycast to next waypoint to ensure that path is still valid, else path to it and
+  // prepend to existing path
+  const glm::vec2 targetPos = centerOfTile(motion.currentWaypoint());
+  _kinematics.push(transform.pos.x, transform.pos.y, targetPos.x, targetPos.y,
+                   motion.oldPosition.x, motion.oldPosition.y,
+                   motion.movementSpeed * transform.terrainSpeed(), transform.rot);
+  _movers.push_back(Mover{&transform, &motion});
+}
+
+void MoveSystem::_writeBack() {
+  // anywhere on a tile is at most this far from its center
+  constexpr float half_diagonal = tile_size * 0.70711f;
+
+  for (std::size_t i = 0; i < _movers.size(); ++i) {
+    TransformComponent& transform = *_movers[i].transform;
+    MotionComponent& motion = *_movers[i].motion;
+
+    if (_kinematics.arrived[i]) {
+      // advance to next waypoint
+      motion.oldPosition = transform.pos;
+      ++motion.waypoint;
+      if (not motion.onPath()) {
+        motion.hasTarget = false;
+      }
+      continue;
+    }
+
+    const glm::vec2 v(_kinematics.vx[i], _kinematics.vy[i]);
+    transform.rot = _kinematics.heading[i];
+
+    // out in the open the step can't touch anything, so skip the sweep
+    const float room = transform.world.region().obstacleDistance().tileDistance(
+                           mapCoordsToTile(transform.pos)) -
+                       half_diagonal;
+    if (room >= clearance + glm::length(v)) {
+      transform.pos += v;
+    } else {
+      transform.translate(v);
     }
-  } else {
-    // TODO: raycast to next waypoint to ensure that path is still valid, else path to it and
-    // prepend to existing path move toward current waypoint
-    auto dir = glm::normalize(targetPos - pos);
-    rot = -glm::atan(dir.y, dir.x) - glm::half_pi<float>();
-    ECS::Manager::getComponent<TransformComponent>(entity).translate(dir * motion.movementSpeed *
-                                                                     dt);
   }
 }
@@ -2,15 +2,31 @@
 
 #include "../Components.h"
 #include "../ECS/System.h"
-#include "../Events.h"
 #include "../GameState.h"
+#include "../Kinematics.h"
+#include "../Unit.h"
 
 /**
  * @brief Applies motion to entities.
- * @detail Supports simple velocity and also path planning.
+ * @detail Supports simple velocity and also path planning. Each tick gathers every walking
+ * mover into packed arrays, steers them all at once, then writes the results back; only movers
+ * near an obstacle go through the full tile collision in translate.
  */
 class MoveSystem : public ECS::System {
+  struct Mover {
+    TransformComponent* transform;
+    MotionComponent* motion;
+  };
+
+  Kinematics _kinematics;
+  std::vector<Mover> _movers;
+
+  void _writeBack();
+
 public:
+  // paths must leave room for the body translate sweeps against the tiles
+  static constexpr float clearance = Unit::body_radius;
+
   MoveSystem(GameState& gameState) : ECS::System(gameState) {
     ECS::ComponentTypeSet requiredComponents;
     requiredComponents.insert(TransformComponent::type);
@@ -19,7 +35,7 @@ public:
     setRequiredComponents(std::move(requiredComponents));
   }
 
+  std::size_t update(float dt) override;
   virtual void updateEntity(float dt, ECS::Entity entity) override;
-  bool tileVisible(Region& region, glm::ivec2 tileCoord, glm::vec2 from);
   void recomputePath(ECS::Entity entity);
 };
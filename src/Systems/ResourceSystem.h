@@ -2,11 +2,12 @@
 
 #include "../Components.h"
 #include "../ECS/System.h"
-#include "../Events.h"
 #include "../GameState.h"
 
 /**
  * @brief Manages the passive resource accumulation system
+ * @detail Income only needs to add up, not arrive every frame, so each structure pays out a few
+ * times a second with the time since its last payout.
  */
 class ResourceSystem : public ECS::System {
   ResourceType& _resources;
@@ -18,6 +19,7 @@ public:
     requiredComponents.insert(ResourceComponent::type);
 
     setRequiredComponents(std::move(requiredComponents));
+    setUpdateInterval(15);
   }
 
   virtual void updateEntity(float dt, ECS::Entity entity) override {
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../Components.h"
+#include "../ECS/System.h"
+#include "../GameState.h"
+#include "../World.h"
+
+/**
+ * @brief Keeps the World's SpatialIndex in step with where movers are
+ * @detail Runs after everything that moves entities, so systems after it query this frame's
+ * positions. Structures never move, so only entities with motion are refreshed. A mover that
+ * crosses into another bucket wakes everything around it, and idle movers sleep until an order or
+ * a push wakes them.
+ */
+class SpatialIndexSystem : public ECS::System {
+public:
+  SpatialIndexSystem(GameState& gameState) : ECS::System(gameState) {
+    ECS::ComponentTypeSet requiredComponents;
+    requiredComponents.insert(TransformComponent::type);
+    requiredComponents.insert(MotionComponent::type);
+
+    setRequiredComponents(std::move(requiredComponents));
+  }
+
+  void updateEntity(float dt, ECS::Entity entity) override {
+    World& world = _gameState.world;
+    const glm::vec2 pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
+
+    if (world.spatialIndex().move(entity, pos)) {
+      world.wakeAround(pos);
+    }
+    if (not ECS::Manager::getComponent<MotionComponent>(entity).hasTarget) {
+      sleep(entity);
+    }
+  }
+};
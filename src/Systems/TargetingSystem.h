@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../Components.h"
+#include "../ECS/System.h"
+#include "../GameState.h"
+#include "../World.h"
+
+/**
+ * @brief Finds something for every fighter without a target to attack
+ * @detail Scanning can lag a step or two, so each fighter only scans every few steps, staggered
+ * so that a wave spawning all at once is scanned over the next few steps instead of in one.
+ * Fighters that have a target sleep here until BattleSystem sees it die, and so do fighters
+ * with nothing hostile anywhere near, until World::wakeAround wakes them.
+ */
+class TargetingSystem : public ECS::System {
+  void _scanForHostiles(const ECS::Entity entity) {
+    auto& pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
+    auto& attack = ECS::Manager::getComponent<AttackComponent>(entity);
+    const SpatialIndex& index = _gameState.world.spatialIndex();
+
+    const bool isUnit =
+        ECS::Manager::getComponent<FactionComponent>(entity).faction == Faction::UNIT;
+    if (isUnit) {
+      const ECS::Entity hostile = index.nearest(pos, attack.attackRange, Faction::ENEMY);
+      if (hostile != ECS::InvalidEntityId) {
+        _engage(entity, hostile);
+        attack.battling = true;
+        return;
+      }
+    } else { // entity is an Enemy, which goes for units before structures
+      for (Faction hostiles : {Faction::UNIT, Faction::STRUCTURE}) {
+        const ECS::Entity hostile = index.nearest(pos, attack.attackRange, hostiles);
+        if (hostile != ECS::InvalidEntityId) {
+          _engage(entity, hostile);
+          return;
+        }
+      }
+    }
+
+    // nothing this far off can get in range without someone crossing buckets and waking us
+    const Faction hostiles = isUnit ? Faction::ENEMY : Faction::UNIT | Faction::STRUCTURE;
+    if (index.nearest(pos, attack.attackRange + World::wake_margin, hostiles) ==
+        ECS::InvalidEntityId) {
+      sleep(entity);
+    }
+  }
+
+  void _engage(const ECS::Entity entity, const ECS::Entity target) {
+    ECS::Manager::getComponent<AttackComponent>(entity).target = target;
+    ECS::Manager::wake(entity); // BattleSystem takes it from here
+    sleep(entity);
+  }
+
+public:
+  // simulation steps between scans for one fighter
+  static constexpr unsigned interval = 3;
+
+  TargetingSystem(GameState& gameState) : ECS::System(gameState) {
+    ECS::ComponentTypeSet requiredComponents;
+    requiredComponents.insert(TransformComponent::type);
+    requiredComponents.insert(HealthComponent::type);
+    requiredComponents.insert(AttackComponent::type);
+
+    setRequiredComponents(std::move(requiredComponents));
+    setUpdateInterval(interval);
+  }
+
+  void updateEntity(float dt, ECS::Entity entity) override {
+    const ECS::Entity target = ECS::Manager::getComponent<AttackComponent>(entity).target;
+    if (ECS::Manager::hasEntity(target)) {
+      sleep(entity); // BattleSystem wakes it when the target dies
+      return;
+    }
+    _scanForHostiles(entity);
+  }
+};
@@ -1,58 +1,100 @@
 #pragma once
 
+#include "../Components.h"
+#include "../ECS/Manager.h"
+#include "../GameState.h"
+#include "../OverlapSolver.h"
+#include "../Unit.h"
+#include "../World.h"
+
+/**
+ * @brief Keeps moving entities from standing on top of each other
+ * @detail Gathers every mover's position, lets OverlapSolver find the overlaps, then translates
+ * each mover once by its summed push. Structures are left out since they never move, and
+ * translate already keeps movers off their tiles. Idle movers give way to ones that are walking
+ * somewhere, so they're easy to push aside.
+ *
+ * An idle mover that no push moved sleeps here, so a resting army costs nothing. It is still in
+ * the way, though: every awake mover looks up the sleepers it overlaps in the SpatialIndex and
+ * wakes them into the same solve. A mover crossing into another bucket wakes them too, through
+ * World::wakeAround, and pushing one wakes it in the other systems.
+ */
 class UnitCollisionSystem : public ECS::System {
-  std::unordered_map<ECS::Entity, bool> _movable;
+  // an idle mover moved less than this by a push is settled, even if a wall or a crowd it can't
+  // get out of keeps pushing it
+  static constexpr float settle_distance = 0.01f * tile_size;
+
+  OverlapSolver _solver;
+
+  std::vector<ECS::Entity> _movers;
+  std::vector<TransformComponent*> _transforms;
+  std::vector<glm::vec2> _positions;
+  std::vector<unsigned char> _idle;
+  std::vector<glm::vec2> _displacement;
+
+  void _gather(ECS::Entity entity) {
+    auto& transform = ECS::Manager::getComponent<TransformComponent>(entity);
+    _movers.push_back(entity);
+    _transforms.push_back(&transform);
+    _positions.push_back(transform.pos);
+    _idle.push_back(not ECS::Manager::getComponent<MotionComponent>(entity).hasTarget);
+  }
+
+  /// adds every sleeper an awake mover overlaps to this solve
+  void _wakeTouchedSleepers() {
+    if (sleepingEntities().empty()) {
+      return;
+    }
+
+    const SpatialIndex& index = _gameState.world.spatialIndex();
+    const std::size_t awake = _movers.size();
+    for (std::size_t i = 0; i < awake; ++i) {
+      index.queryRadius(_positions[i], 2 * Unit::unit_size, Faction::UNIT | Faction::ENEMY,
+                        [this](const SpatialIndex::Item& item) {
+                          if (wake(item.entity)) {
+                            _gather(item.entity);
+                          }
+                        });
+    }
+  }
 
 public:
   UnitCollisionSystem(GameState& gameState) : ECS::System(gameState) {
     ECS::ComponentTypeSet requiredComponents;
     requiredComponents.insert(TransformComponent::type);
+    requiredComponents.insert(MotionComponent::type);
 
     setRequiredComponents(std::move(requiredComponents));
   }
 
-  bool registerEntity(ECS::Entity entity) {
-    _movable.insert({entity, ECS::Manager::getComponentStore<MotionComponent>().has(entity)});
+  std::size_t update(float dt) override {
+    _movers.clear();
+    _transforms.clear();
+    _positions.clear();
+    _idle.clear();
 
-    return ECS::System::registerEntity(entity);
-  }
+    auto result = ECS::System::update(dt);
+    _wakeTouchedSleepers();
 
-  void updateEntity(float dt, ECS::Entity entity) override {
-    const glm::vec2& pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
-    for (ECS::Entity other : entities()) {
-      bool eMovable = _movable.at(entity);
-      bool oMovable = _movable.at(other);
-      if (not eMovable && not oMovable) {
-        continue;
+    _solver.solve(_positions, _idle, Unit::unit_size, _displacement);
+    for (std::size_t i = 0; i < _transforms.size(); ++i) {
+      glm::vec2& pos = _transforms[i]->pos;
+      const glm::vec2 before = pos;
+      if (_displacement[i] != glm::vec2(0, 0)) {
+        _transforms[i]->translate(_displacement[i]);
       }
-
-      // make entities that are just standing around easy to push
-      if (ECS::Manager::hasComponent<MotionComponent>(entity) &&
-          ECS::Manager::getComponent<MotionComponent>(entity).hasTarget) {
-        if (ECS::Manager::hasComponent<MotionComponent>(other) &&
-            not ECS::Manager::getComponent<MotionComponent>(other).hasTarget) {
-          eMovable = false;
-        }
-      }
-
-      const glm::vec2& otherPos = ECS::Manager::getComponent<TransformComponent>(other).pos;
-      const float dist = glm::distance(pos, otherPos);
-      if (dist == 0) {
-        continue;
-      } else if (dist < Unit::unit_size * 2) {
-        float overlapDistance = Unit::unit_size * 2 - dist;
-        glm::vec2 displacement = glm::normalize(otherPos - pos) * overlapDistance;
-
-        if (eMovable && oMovable) {
-          displacement *= 0.5f;
-        }
-        if (eMovable) {
-          ECS::Manager::getComponent<TransformComponent>(entity).translate(-displacement);
-        }
-        if (oMovable) {
-          ECS::Manager::getComponent<TransformComponent>(other).translate(displacement);
-        }
+      const glm::vec2 moved = pos - before;
+      if (glm::dot(moved, moved) > settle_distance * settle_distance) {
+        ECS::Manager::wake(_movers[i]); // a pushed idle mover has to be reindexed
+      } else if (_idle[i]) {
+        sleep(_movers[i]); // settled
       }
     }
+
+    return result;
+  }
+
+  void updateEntity(float dt, ECS::Entity entity) override {
+    _gather(entity);
   }
 };
@@ -1,24 +1,22 @@
 #pragma once
 
+#include "../Components.h"
+#include "../ECS/System.h"
+#include "../Events.h"
+#include "../GameState.h"
+#include "../Graphics.h"
+#include "../GroupMove.h"
+#include "../World.h"
+#include "MoveSystem.h"
+
 /**
  * @brief Allows the user to send commands to selected commandable entities.
  *
  */
 class UnitCommandSystem : public ECS::System, ECS::EventSubscriber<MouseDownEvent> {
-  std::vector<Enemy>& _enemies;
-
   bool _attackClickedEnemy(glm::vec2 clickedPos) {
-    ECS::Entity found = ECS::InvalidEntityId;
-    for (auto enemy : _enemies) {
-      const ECS::Entity enemyId = enemy.id;
-
-      glm::vec2 pos = ECS::Manager::getComponent<TransformComponent>(enemyId).pos;
-      float dist = glm::distance(clickedPos, pos);
-
-      if (dist < Unit::unit_size && found == ECS::InvalidEntityId) {
-        found = enemyId;
-      }
-    }
+    const ECS::Entity found =
+        _gameState.world.spatialIndex().nearest(clickedPos, Unit::unit_size, Faction::ENEMY);
 
     if (found == ECS::InvalidEntityId) {
       return false;
@@ -28,22 +26,50 @@ class UnitCommandSystem : public ECS::System, ECS::EventSubscriber<MouseDownEven
       bool selected = ECS::Manager::getComponent<SelectableComponent>(entity).selected;
       if (selected) {
         ECS::Manager::getComponent<AttackComponent>(entity).target = found;
+        ECS::Manager::wake(entity);
       }
     }
     return true;
   }
 
   void _invokePositionHandler(float x, float y) {
+    std::vector<ECS::Entity> movers;
+    std::vector<glm::vec2> positions;
+
     for (ECS::Entity entity : entities()) {
       bool selected = ECS::Manager::getComponent<SelectableComponent>(entity).selected;
-      if (selected) {
+      if (not selected) {
+        continue;
+      }
+      if (ECS::Manager::hasComponent<MotionComponent>(entity) &&
+          ECS::Manager::hasComponent<TransformComponent>(entity)) {
+        movers.push_back(entity);
+        positions.push_back(ECS::Manager::getComponent<TransformComponent>(entity).pos);
+      } else {
         ECS::Manager::getComponent<CommandableComponent>(entity).positionHandler({x, y});
       }
     }
+
+    if (not movers.empty()) {
+      _groupMove(movers, positions, {x, y});
+    }
+  }
+
+  // one search for the whole selection instead of one per unit
+  void _groupMove(const std::vector<ECS::Entity>& movers, const std::vector<glm::vec2>& positions,
+                  glm::vec2 target) {
+    World& world = ECS::Manager::getComponent<TransformComponent>(movers.front()).world;
+    std::vector<Path> paths = planGroupMove(world.region(), world.pathCache(), positions, target,
+                                            MoveSystem::clearance);
+    for (std::size_t i = 0; i < movers.size(); ++i) {
+      ECS::Manager::getComponent<MotionComponent>(movers[i]).follow(std::move(paths[i]),
+                                                                    positions[i]);
+      ECS::Manager::wake(movers[i]);
+    }
   }
 
 public:
-  UnitCommandSystem(GameState& gameState) : ECS::System(gameState), _enemies(gameState.enemies) {
+  UnitCommandSystem(GameState& gameState) : ECS::System(gameState) {
     ECS::ComponentTypeSet requiredComponents;
     requiredComponents.insert(SelectableComponent::type);
     requiredComponents.insert(CommandableComponent::type);
@@ -52,6 +78,10 @@ public:
     ECS::EventManager::connect<MouseDownEvent>(this);
   }
 
+  ~UnitCommandSystem() {
+    ECS::EventManager::disconnect<MouseDownEvent>(this);
+  }
+
   void updateEntity(float dt, ECS::Entity entity) override {
     // not yet used
   }
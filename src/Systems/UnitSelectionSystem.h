@@ -1,5 +1,12 @@
 #pragma once
 
+#include "../Components.h"
+#include "../ECS/System.h"
+#include "../Events.h"
+#include "../GameState.h"
+#include "../Graphics.h"
+#include "../World.h"
+
 /**
  * @brief Allows user to select entities that have a position and are selectable.
  * @detail The user can left-click to select an entity or left-click and drag to select several.
@@ -16,31 +23,50 @@ class UnitSelectSystem : public ECS::System,
   glm::vec2 _boxTopLeft, _boxBottomRight;
   bool _selectionChanged = false;
 
-  std::size_t _selectionCount;
-  glm::vec2 _selectionCentroid;
+  std::size_t _selectionCount = 0;
+  glm::vec2 _selectionCentroid{0, 0};
 
-  void _selectClicked(glm::vec2 clickedPos) {
-    ECS::Entity found = ECS::InvalidEntityId;
-    for (ECS::Entity entity : entities()) {
-      glm::vec2 pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
-      float dist = glm::distance(clickedPos, pos);
+  std::vector<ECS::Entity> _selected; // so a new selection only has to touch the old one
+
+  View& _view;
 
-      ECS::Manager::getComponent<SelectableComponent>(entity).selected = false;
+  void _select(ECS::Entity entity) {
+    if (ECS::Manager::hasComponent<SelectableComponent>(entity)) {
+      ECS::Manager::getComponent<SelectableComponent>(entity).selected = true;
+      _selected.push_back(entity);
+    }
+  }
 
-      if (dist < Unit::unit_size && found == ECS::InvalidEntityId) {
-        found = entity;
+  void _deselectAll() {
+    for (ECS::Entity entity : _selected) {
+      if (ECS::Manager::hasComponent<SelectableComponent>(entity)) {
+        ECS::Manager::getComponent<SelectableComponent>(entity).selected = false;
       }
     }
+    _selected.clear();
+  }
 
+  void _selectClicked(glm::vec2 clickedPos) {
+    _deselectAll();
+
+    const ECS::Entity found =
+        _gameState.world.spatialIndex().nearest(clickedPos, Unit::unit_size, Faction::UNIT);
     if (found != ECS::InvalidEntityId) {
-      ECS::Manager::getComponent<SelectableComponent>(found).selected = true;
+      _select(found);
       _selectionCount = 1;
       _selectionCentroid = ECS::Manager::getComponent<TransformComponent>(found).pos;
     }
   }
 
+  void _selectBox() {
+    _deselectAll();
+    _gameState.world.spatialIndex().queryBox(
+        _boxTopLeft, _boxBottomRight, Faction::UNIT,
+        [this](const SpatialIndex::Item& item) { _select(item.entity); });
+  }
+
 public:
-  UnitSelectSystem(GameState& gameState) : ECS::System(gameState) {
+  UnitSelectSystem(GameState& gameState, View& view) : ECS::System(gameState), _view(view) {
     ECS::ComponentTypeSet requiredComponents;
     requiredComponents.insert(TransformComponent::type);
     requiredComponents.insert(SelectableComponent::type);
@@ -52,16 +78,15 @@ public:
     ECS::EventManager::connect<MouseUpEvent>(this);
   }
 
+  ~UnitSelectSystem() {
+    ECS::EventManager::disconnect<MouseDownEvent>(this);
+    ECS::EventManager::disconnect<MouseMoveEvent>(this);
+    ECS::EventManager::disconnect<MouseUpEvent>(this);
+  }
+
   std::size_t update(float dt) override {
     if (_selectionChanged) {
-      // draw box around selection
-      auto size_axes = _boxBottomRight - _boxTopLeft;
-      RectangleBatch()
-          .add()
-          .position((_boxTopLeft + _boxBottomRight) / 2.f)
-          .size(size_axes)
-          .color({0.8, 0.8, 1, 0.4})
-          .draw(_gameState._view);
+      _selectBox();
     }
 
     _selectionCount = 0;
@@ -77,28 +102,35 @@ public:
           selectable.selectionCentroid = _selectionCentroid;
         }
       }
+    }
+
+    return result;
+  }
 
+  void render(float alpha) override {
+    if (_selectionChanged) {
+      // draw box around selection
+      auto size_axes = _boxBottomRight - _boxTopLeft;
+      RectangleBatch()
+          .add()
+          .position((_boxTopLeft + _boxBottomRight) / 2.f)
+          .size(size_axes)
+          .color({0.8, 0.8, 1, 0.4})
+          .draw(_view);
+    }
+
+    if (_selectionCount > 0) {
       RectangleBatch()
           .add()
           .position(_selectionCentroid)
           .size({0.1, 0.1})
           .color({0.5, 1.0, 0.0, 0.5})
-          .draw(_gameState._view);
+          .draw(_view);
     }
-
-    return result;
   }
 
   void updateEntity(float dt, ECS::Entity entity) override {
-    auto& selected = ECS::Manager::getComponent<SelectableComponent>(entity).selected;
-
-    if (_selectionChanged) {
-      const glm::vec2 pos = ECS::Manager::getComponent<TransformComponent>(entity).pos;
-      bool inBox = pos.x >= _boxTopLeft.x && pos.x <= _boxBottomRight.x && pos.y >= _boxTopLeft.y &&
-                   pos.y <= _boxBottomRight.y;
-
-      selected = inBox;
-    }
+    const bool selected = ECS::Manager::getComponent<SelectableComponent>(entity).selected;
 
     if (selected) {
       _selectionCount += 1;
@@ -133,6 +165,9 @@ public:
   }
 
   void receive(const MouseUpEvent& e) {
+    if (_selectionChanged) {
+      _selectBox(); // the last box may have been dragged out since the last update
+    }
     _mouseDown = false;
     _selectionChanged = false;
   }
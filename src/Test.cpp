@@ -6,11 +6,34 @@
 #include <glm/gtx/string_cast.hpp>
 
 #include "Game.h"
+#include "BlockGrid.h"
+#include "BucketQueue.h"
+#include "ChangeJournal.h"
+#include "Definitions.h"
+#include "DistanceField.h"
+#include "FactionRoster.h"
+#include "FixedStep.h"
 #include "Graphics.h"
+#include "Grid.h"
+#include "GroupMove.h"
+#include "Kinematics.h"
+#include "LineOfSight.h"
+#include "OverlapSolver.h"
 #include "Path.h"
+#include "PathCache.h"
 #include "RegionGenerator.h"
+#include "SpatialIndex.h"
+#include "Sweep.h"
 #include "World.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
 
 // Game g; // sets up opengl
 
@@ -43,9 +66,589 @@
 // }
 
 TEST(Pathing, findPathSpeed) {
-  Region region{{world_size, std::vector<Tile>(world_size, Tile::GRASS)}};
+  Region region(default_world_size);
   for (int i = 0; i < 100; ++i) {
-    findPath(region, {0, 0}, {world_size - 1, world_size - 1});
+    findPath(region, {0, 0}, {default_world_size - 1, default_world_size - 1});
+  }
+}
+
+TEST(Pathing, anyAngle) {
+  Region region(default_world_size);
+
+  // open ground is a single straight leg
+  Path path = findPath(region, {0, 0}, {default_world_size - 1, 40});
+  ASSERT_EQ(path.size(), 1u);
+  EXPECT_EQ(path.back(), glm::ivec2(default_world_size - 1, 40));
+
+  // a wall with one gap needs a waypoint by the gap, and every leg is straight and clear
+  for (int y = 0; y < default_world_size - 1; ++y) {
+    region.setCell({50, y}, Tile::WATER);
+  }
+  path = findPath(region, {10, 10}, {90, 10}, 0.45);
+  ASSERT_FALSE(path.empty());
+  EXPECT_LE(path.size(), 4u);
+  EXPECT_EQ(path.back(), glm::ivec2(90, 10));
+
+  const BitGrid& walkable = region.walkability();
+  glm::ivec2 last{10, 10};
+  for (auto p : path) {
+    EXPECT_TRUE(lineOfSight(walkable, centerOfTile(last), centerOfTile(p), 0.45));
+    last = p;
+  }
+
+  region.setCell({50, default_world_size - 1}, Tile::WATER);
+  EXPECT_TRUE(findPath(region, {10, 10}, {90, 10}).empty());
+}
+
+TEST(Pathing, terrainCost) {
+  Region region(default_world_size);
+  for (int x = 20; x <= 80; ++x) {
+    for (int y = 0; y <= 20; ++y) {
+      region.setCell({x, y}, Tile::SAND);
+    }
+  }
+
+  // straight through is 60 tiles of sand, so going around the field is cheaper
+  Path path = findPath(region, {10, 10}, {90, 10});
+  ASSERT_FALSE(path.empty());
+  int highest = 0;
+  for (auto p : path) {
+    highest = std::max(highest, p.y);
+  }
+  EXPECT_GT(highest, 20);
+
+  // but a narrow strip is crossed rather than walked around
+  path = findPath(region, {50, 30}, {50, 10});
+  ASSERT_EQ(path.size(), 1u);
+}
+
+TEST(Pathing, cache) {
+  Region region(default_world_size);
+  region.touch({0, 0}, {default_world_size - 1, default_world_size - 1});
+  for (int y = 0; y < default_world_size - 1; ++y) {
+    region.setCell({50, y}, Tile::WATER);
+  }
+
+  PathCache cache;
+  const Path path = cache.find(region, {10, 10}, {90, 10});
+  EXPECT_EQ(cache.find(region, {10, 10}, {90, 10}), path);
+  EXPECT_EQ(cache.stats().misses, 1u);
+  EXPECT_EQ(cache.stats().hits, 1u);
+
+  // starting next to the first leg reuses the rest of the path
+  ASSERT_FALSE(path.empty());
+  const glm::ivec2 nearFirstLeg = (glm::ivec2(10, 10) + path.front()) / 2 + glm::ivec2(1, 0);
+  const Path spliced = cache.find(region, nearFirstLeg, {90, 10});
+  EXPECT_EQ(cache.stats().splices, 1u);
+  ASSERT_FALSE(spliced.empty());
+  EXPECT_EQ(spliced.back(), glm::ivec2(90, 10));
+
+  // blocking tiles away from the path leaves it cached, but opening any makes it stale
+  region.setCell({5, 60}, Tile::WATER);
+  EXPECT_EQ(cache.find(region, {10, 10}, {90, 10}), path);
+  EXPECT_EQ(cache.stats().hits, 2u);
+  region.setCell({5, 60}, Tile::GRASS);
+  EXPECT_EQ(cache.find(region, {10, 10}, {90, 10}), path);
+  EXPECT_EQ(cache.stats().misses, 2u);
+
+  // so does blocking one on it
+  region.setCell({50, default_world_size - 1}, Tile::WATER);
+  EXPECT_TRUE(cache.find(region, {10, 10}, {90, 10}).empty());
+  EXPECT_EQ(cache.stats().misses, 3u);
+
+  // generating chunks far away, or restyling a blocked tile beside the path, leaves it cached
+  Region streamed(Region::chunk_size * 4);
+  streamed.setCell({10, 3}, Tile::WATER);
+  PathCache streamedCache;
+  const Path near = streamedCache.find(streamed, {2, 2}, {20, 2});
+  streamed.touch({Region::chunk_size * 3, Region::chunk_size * 3});
+  streamed.setCell({10, 3}, Tile::MOUNTAIN);
+  EXPECT_EQ(streamedCache.find(streamed, {2, 2}, {20, 2}), near);
+  EXPECT_EQ(streamedCache.stats().hits, 1u);
+}
+
+TEST(Region, changeJournal) {
+  Region region(default_world_size);
+  region.touch({0, 0}, {default_world_size - 1, default_world_size - 1});
+  const std::uint64_t start = region.navVersion();
+
+  region.setCell({3, 4}, Tile::WATER);
+  region.setCell({3, 4}, Tile::WATER); // no change, so not recorded
+  region.setCell({5, 5}, Tile::SAND);
+  region.setCell({5, 5}, Tile::GRASS);
+  std::vector<ChangeJournal::Change> changes;
+  auto collect = [&changes](const ChangeJournal::Change& c) { changes.push_back(c); };
+  ASSERT_TRUE(region.changes().forEachSince(start, collect));
+  ASSERT_EQ(changes.size(), 3u);
+  EXPECT_EQ(changes[0].lo, glm::ivec2(3, 4));
+  EXPECT_FALSE(changes[0].opened);
+  EXPECT_FALSE(changes[1].opened); // sand is slower than grass
+  EXPECT_TRUE(changes[2].opened);
+  EXPECT_EQ(changes[2].version, region.navVersion());
+  for (const ChangeJournal::Change& c : changes) {
+    EXPECT_TRUE(c.nav);
+  }
+
+  // water to mountain still can't be crossed, so only the look changes
+  region.setCell({3, 4}, Tile::MOUNTAIN);
+  changes.clear();
+  ASSERT_TRUE(region.changes().forEachSince(start + 3, collect));
+  ASSERT_EQ(changes.size(), 1u);
+  EXPECT_FALSE(changes[0].nav);
+  EXPECT_FALSE(changes[0].opened);
+
+  // generating a chunk records the whole of it
+  Region streamed(Region::chunk_size * 4);
+  streamed.touch({40, 40});
+  changes.clear();
+  ASSERT_TRUE(streamed.changes().forEachSince(0, collect));
+  ASSERT_EQ(changes.size(), 1u);
+  EXPECT_EQ(changes[0].lo, glm::ivec2(Region::chunk_size));
+  EXPECT_EQ(changes[0].hi, glm::ivec2(Region::chunk_size * 2 - 1));
+  EXPECT_FALSE(changes[0].opened); // pathing generates what it reaches, so nothing went around it
+
+  // falling further behind than the journal holds means starting over
+  ChangeJournal journal(2);
+  for (int i = 0; i < 3; ++i) {
+    journal.record({i, i}, {i, i}, false);
+  }
+  EXPECT_FALSE(journal.forEachSince(0, collect));
+  EXPECT_TRUE(journal.covers(1));
+  EXPECT_TRUE(journal.covers(3));
+}
+
+TEST(Pathing, groupMove) {
+  Region region(default_world_size);
+  for (int y = 0; y < default_world_size - 1; ++y) {
+    region.setCell({50, y}, Tile::WATER);
+  }
+
+  std::vector<glm::vec2> movers;
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j < 5; ++j) {
+      movers.push_back(centerOfTile(glm::ivec2(10 + i, 10 + j)));
+    }
+  }
+
+  PathCache cache;
+  const std::vector<Path> paths = planGroupMove(region, cache, movers, {90.5, 10.5}, 0.45);
+  ASSERT_EQ(paths.size(), movers.size());
+
+  // one search for the group, and every mover can see the group path
+  EXPECT_EQ(cache.stats().misses, 1u);
+
+  std::set<std::pair<int, int>> slots;
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    ASSERT_FALSE(paths[i].empty());
+    const glm::ivec2 slot = paths[i].back();
+    EXPECT_TRUE(slots.insert({slot.x, slot.y}).second);
+    EXPECT_TRUE(region.walkable(slot));
+    EXPECT_LE(glm::distance(glm::vec2(slot), glm::vec2(90, 10)), 5.f);
+
+    glm::vec2 last = movers[i];
+    for (auto p : paths[i]) {
+      EXPECT_TRUE(lineOfSight(region.walkability(), last, centerOfTile(p), 0.45));
+      last = centerOfTile(p);
+    }
+  }
+}
+
+TEST(SpatialIndex, queries) {
+  SpatialIndex index;
+  index.insert(1, {10.5, 10.5}, Faction::UNIT);
+  index.insert(2, {12.5, 10.5}, Faction::ENEMY);
+  index.insert(3, {30.5, 30.5}, Faction::ENEMY);
+  index.insert(4, {11, 11}, Faction::STRUCTURE);
+
+  EXPECT_EQ(index.nearest({10.5, 10.5}, 5, Faction::ENEMY), 2u);
+  EXPECT_EQ(index.nearest({10.5, 10.5}, 1, Faction::ENEMY), ECS::InvalidEntityId);
+  EXPECT_EQ(index.nearest({10.5, 10.5}, 5, Faction::ENEMY | Faction::STRUCTURE), 4u);
+  EXPECT_EQ(index.nearest({0, 0}, 100, Faction::ENEMY), 2u);
+
+  std::set<ECS::Entity> found;
+  index.queryRadius({11, 11}, 2, Faction::UNIT | Faction::ENEMY,
+                    [&found](const SpatialIndex::Item& item) { found.insert(item.entity); });
+  EXPECT_EQ(found, (std::set<ECS::Entity>{1, 2}));
+
+  // moving across buckets and removing keep the other entries reachable
+  EXPECT_FALSE(index.move(2, {12, 11}));
+  EXPECT_TRUE(index.move(2, {31, 31}));
+  index.remove(1);
+  found.clear();
+  index.queryBox({0, 0}, {default_world_size, default_world_size}, Faction::UNIT | Faction::ENEMY,
+                 [&found](const SpatialIndex::Item& item) { found.insert(item.entity); });
+  EXPECT_EQ(found, (std::set<ECS::Entity>{2, 3}));
+  EXPECT_EQ(index.nearest({30.5, 30.5}, 0.1, Faction::ENEMY), 3u);
+  EXPECT_EQ(index.size(), 3u);
+}
+
+TEST(FactionRoster, swapRemove) {
+  FactionRoster roster;
+  for (ECS::Entity e = 1; e <= 4; ++e) {
+    EXPECT_TRUE(roster.add(e, Faction::UNIT));
+  }
+  EXPECT_TRUE(roster.add(5, Faction::ENEMY));
+  EXPECT_FALSE(roster.add(5, Faction::STRUCTURE));
+  EXPECT_EQ(roster.factionOf(5), Faction::ENEMY);
+
+  // the last unit takes the removed one's place, and can still be removed itself
+  EXPECT_TRUE(roster.remove(2));
+  EXPECT_FALSE(roster.remove(2));
+  EXPECT_EQ(roster.members(Faction::UNIT), (std::vector<ECS::Entity>{1, 4, 3}));
+  EXPECT_TRUE(roster.remove(4));
+  EXPECT_EQ(roster.members(Faction::UNIT), (std::vector<ECS::Entity>{1, 3}));
+  EXPECT_EQ(roster.members(Faction::ENEMY), (std::vector<ECS::Entity>{5}));
+  EXPECT_TRUE(roster.members(Faction::STRUCTURE).empty());
+  EXPECT_EQ(roster.factionOf(4), Faction::NONE);
+  EXPECT_EQ(roster.size(), 3u);
+}
+
+TEST(OverlapSolver, separate) {
+  OverlapSolver solver;
+  std::vector<glm::vec2> displacement;
+
+  // two walkers split the overlap, an idle one gets out of a walker's way entirely
+  solver.solve({{0, 0}, {0.6, 0}, {5, 5}, {5.5, 5}}, {0, 0, 1, 0}, 0.5, displacement);
+  EXPECT_FLOAT_EQ(displacement[0].x, -0.2f);
+  EXPECT_FLOAT_EQ(displacement[1].x, 0.2f);
+  EXPECT_FLOAT_EQ(displacement[2].x, -0.5f);
+  EXPECT_EQ(displacement[3], glm::vec2(0, 0));
+
+  // a crowd packed two per tile only costs neighbor checks
+  std::vector<glm::vec2> crowd;
+  for (int i = 0; i < 4000; ++i) {
+    crowd.push_back({(i % 60) * 0.5f + 20, (i / 60) * 0.5f + 10});
+  }
+  std::vector<unsigned char> yields(crowd.size(), 0);
+  for (int i = 0; i < 100; ++i) {
+    solver.solve(crowd, yields, 0.5, displacement);
+  }
+  ASSERT_EQ(displacement.size(), crowd.size());
+  EXPECT_LT(displacement[0].x, 0);
+  EXPECT_FLOAT_EQ(displacement[0].x, displacement[0].y);
+}
+
+TEST(OverlapSolver, thousandsWithinAMillisecond) {
+  // an army milling around a 64 tile square, some of it walking
+  constexpr int movers = 2500;
+  constexpr int rounds = 200;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> coord(0, 64);
+  std::vector<glm::vec2> army;
+  std::vector<unsigned char> yields;
+  for (int i = 0; i < movers; ++i) {
+    army.push_back({coord(rng), coord(rng)});
+    yields.push_back(i % 4 != 0);
+  }
+
+  OverlapSolver solver;
+  std::vector<glm::vec2> displacement;
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i) {
+    solver.solve(army, yields, Unit::unit_size, displacement);
+  }
+  const double perSolve =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() / rounds;
+
+  std::cout << movers << " movers: " << perSolve * 1e3 << "ms per solve" << std::endl;
+  EXPECT_LT(perSolve, 1e-3);
+}
+
+TEST(Kinematics, steer) {
+  // seven movers, so both the four-wide kernel and the scalar tail run
+  Kinematics k;
+  std::mt19937 mt(0);
+  std::uniform_real_distribution<float> coord{0, 20};
+  for (int i = 0; i < 7; ++i) {
+    const float x = coord(mt), y = coord(mt);
+    k.push(x, y, coord(mt), coord(mt), x, y, 2, 0.5f);
+  }
+  // already there, and walked past the waypoint
+  k.x[1] = k.targetX[1] - 0.1f;
+  k.y[1] = k.targetY[1];
+  k.fromX[5] = k.targetX[5] + 3;
+  k.fromY[5] = k.targetY[5];
+  k.x[5] = k.targetX[5] - 2;
+  k.y[5] = k.targetY[5];
+
+  steer(k, 0.5f, 0.1f);
+
+  for (std::size_t i = 0; i < k.size(); ++i) {
+    if (i == 1 || i == 5) {
+      EXPECT_TRUE(k.arrived[i]);
+      EXPECT_EQ(k.vx[i], 0);
+      EXPECT_EQ(k.vy[i], 0);
+      EXPECT_EQ(k.heading[i], 0.5f);
+      continue;
+    }
+    const glm::vec2 dir = glm::normalize(glm::vec2(k.targetX[i] - k.x[i], k.targetY[i] - k.y[i]));
+    EXPECT_FALSE(k.arrived[i]);
+    EXPECT_NEAR(k.vx[i], dir.x * 0.2f, 1e-5);
+    EXPECT_NEAR(k.vy[i], dir.y * 0.2f, 1e-5);
+    EXPECT_NEAR(k.heading[i], -std::atan2(dir.y, dir.x) - glm::half_pi<float>(), 1e-4);
+  }
+
+  for (float a = -3.14f; a < 3.14f; a += 0.01f) {
+    EXPECT_NEAR(fastAtan2(std::sin(a) * 3, std::cos(a) * 3), a, 1e-4);
+  }
+}
+
+TEST(SmallVector, spill) {
+  SmallVector<int, 3> v{1, 2};
+  v.push_back(3);
+  EXPECT_EQ(v.size(), 3u);
+
+  // growing past the inline buffer keeps the elements in order and contiguous
+  const std::vector<int> more{4, 5, 6};
+  v.append(more.begin(), more.end());
+  EXPECT_EQ(std::vector<int>(v.begin(), v.end()), (std::vector<int>{1, 2, 3, 4, 5, 6}));
+
+  SmallVector<int, 3> copy = v;
+  EXPECT_EQ(copy, v);
+  copy.pop_back();
+  EXPECT_NE(copy, v);
+
+  v.clear();
+  EXPECT_TRUE(v.empty());
+  v.push_back(7);
+  EXPECT_EQ(v.front(), 7);
+  EXPECT_EQ(v.back(), 7);
+}
+
+TEST(BucketQueue, order) {
+  BucketQueue<int> queue(4);
+  for (int key : {5, 3, 40, 3, 17, 9}) {
+    queue.push(key, key);
+  }
+  std::vector<int> popped;
+  while (not queue.empty()) {
+    popped.push_back(queue.pop());
+    if (popped.back() == 9) {
+      queue.push(2, 2); // behind the minimum, so it comes out next
+    }
+  }
+  EXPECT_EQ(popped, (std::vector<int>{3, 3, 5, 9, 2, 17, 40}));
+}
+
+TEST(BitGrid, wordScans) {
+  BitGrid grid(130, 3);
+  grid.set({0, 1}, true);
+  grid.set({63, 1}, true);
+  grid.set({64, 1}, true);
+  grid.set({129, 2}, true);
+
+  EXPECT_EQ(grid.count(), 4u);
+  EXPECT_EQ(grid.count({1, 0}, {64, 2}), 2u);
+  EXPECT_EQ(grid.findNext(1, 1), 63);
+  EXPECT_EQ(grid.findNext(65, 1), -1);
+  EXPECT_EQ(grid.findNext(70, 2), 129);
+  EXPECT_TRUE(grid.any({120, 0}, {200, 5}));
+  EXPECT_FALSE(grid.any({1, 0}, {62, 2}));
+
+  std::vector<glm::ivec2> set;
+  grid.forEachSet([&set](glm::ivec2 p) { set.push_back(p); });
+  EXPECT_EQ(set.size(), 4u);
+
+  grid.fill(true);
+  EXPECT_EQ(grid.count(), 390u);
+  EXPECT_TRUE(grid.all({0, 0}, {129, 2}));
+  EXPECT_FALSE(grid.all({0, 0}, {130, 2}));
+}
+
+TEST(Region, walkability) {
+  Region region(default_world_size);
+  EXPECT_EQ(region.walkability().count(), 0u); // nothing generated yet
+  region.touch({0, 0}, {default_world_size - 1, default_world_size - 1});
+  EXPECT_EQ(region.walkability().count(),
+            static_cast<std::size_t>(default_world_size * default_world_size));
+
+  region.setCell({3, 4}, Tile::WATER);
+  EXPECT_TRUE(region.addStructure({5, 6}, 7));
+  EXPECT_FALSE(region.addStructure({5, 6}, 8));
+  EXPECT_EQ(region.structureAt({5, 6}), 7u);
+  EXPECT_FALSE(region.walkable({3, 4}));
+  EXPECT_FALSE(region.walkable({5, 6}));
+
+  region.setCell({3, 4}, Tile::SAND);
+  region.removeStructure({5, 6});
+  EXPECT_TRUE(region.walkable({3, 4}));
+  EXPECT_TRUE(region.walkable({5, 6}));
+  EXPECT_EQ(region.structureAt({5, 6}), ECS::InvalidEntityId);
+}
+
+TEST(Region, chunks) {
+  // not a whole number of chunks
+  Region region(Region::chunk_size * 2 + 5, Tile::SAND);
+  const int last = region.size() - 1;
+  for (glm::ivec2 p : {glm::ivec2(0, 0), glm::ivec2(31, 32), glm::ivec2(32, 31),
+                       glm::ivec2(last, 0), glm::ivec2(last, last)}) {
+    EXPECT_EQ(region.at(p), Tile::SAND);
+    region.setCell(p, Tile::WATER);
+  }
+  EXPECT_EQ(region.at({31, 32}), Tile::WATER);
+  EXPECT_EQ(region.at({32, 32}), Tile::SAND);
+  EXPECT_EQ(region.at({31, 31}), Tile::SAND);
+  EXPECT_EQ(region.at({last, last}), Tile::WATER);
+  EXPECT_EQ(region.at({last + 1, 0}), Tile::NONE);
+  region.touch({0, 0}, {last, last});
+  EXPECT_EQ(region.walkability().count(),
+            static_cast<std::size_t>(region.size() * region.size() - 5));
+
+  // big maps live on the heap, path search included
+  Region big(2048);
+  Path path = findPath(big, {0, 0}, {2047, 2047});
+  ASSERT_EQ(path.size(), 1u);
+  EXPECT_EQ(path.back(), glm::ivec2(2047, 2047));
+}
+
+TEST(Region, streaming) {
+  constexpr int size = Region::chunk_size * 8;
+  Region eager(size), streamed(size);
+  RegionGenerator().generate(eager);
+  RegionGenerator().generate(streamed);
+  streamed.setChunkBudget(4);
+
+  // chunks are only generated once something touches them
+  EXPECT_EQ(streamed.generatedChunks(), 0u);
+  EXPECT_FALSE(streamed.walkable({size / 2, size / 2}));
+  streamed.touch({size / 2, size / 2});
+  EXPECT_EQ(streamed.generatedChunks(), 1u);
+  EXPECT_TRUE(streamed.walkable({size / 2, size / 2}));
+
+  // edits survive being paged out and back in, and memory stays within the budget
+  for (int y = 0; y < size; y += 7) {
+    for (int x = 0; x < size; x += 7) {
+      eager.setCell({x, y}, Tile::SAND);
+      streamed.setCell({x, y}, Tile::SAND);
+      EXPECT_LE(streamed.residentChunks(), 4u);
+    }
+  }
+  EXPECT_EQ(streamed.generatedChunks(), 64u);
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      ASSERT_EQ(streamed.at({x, y}), eager.at({x, y}));
+    }
+  }
+  EXPECT_EQ(streamed.walkability().count(), eager.walkability().count());
+
+  // chunk by chunk updates end up where a full rebuild would, give or take the brushfire's
+  // small errors, which depend on the order tiles were filled in
+  const DistanceField rebuilt(streamed.walkability());
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      ASSERT_NEAR(streamed.obstacleDistance().tileDistance({x, y}),
+                  rebuilt.tileDistance({x, y}), 0.1);
+    }
+  }
+}
+
+TEST(Sweep, slideAndNoTunneling) {
+  BitGrid walkable(10, 10, true);
+  for (int y = 0; y < 10; ++y) {
+    walkable.set({5, y}, false);
+  }
+
+  // a long move is stopped at the wall, however far it would have gone
+  Sweep sweep = sweepCircle(walkable, {2.5, 2.5}, {50, 0}, 0.45);
+  ASSERT_TRUE(sweep.hit);
+  EXPECT_NEAR(sweep.contact.x, 5 - 0.45, 0.01);
+  EXPECT_EQ(sweep.normal, glm::vec2(-1, 0));
+  EXPECT_EQ(sweep.slide, glm::vec2(0, 0));
+
+  // a glancing move keeps its motion along the wall
+  sweep = sweepCircle(walkable, {4, 2.5}, {2, 1}, 0.45);
+  ASSERT_TRUE(sweep.hit);
+  EXPECT_NEAR(sweep.slide.x, 0, 1e-5);
+  EXPECT_GT(sweep.slide.y, 0);
+
+  // a rounded corner lets a circle closer diagonally than a square would
+  BitGrid corner(10, 10, true);
+  corner.set({5, 5}, false);
+  EXPECT_FALSE(sweepCircle(corner, {3.5, 3.5}, {1.1, 1.1}, 0.45).hit);
+  EXPECT_TRUE(sweepCircle(corner, {3.5, 3.5}, {1.2, 1.2}, 0.45).hit);
+}
+
+TEST(DistanceField, incremental) {
+  BitGrid walkable(40, 30, true);
+  DistanceField field(walkable);
+  EXPECT_FLOAT_EQ(field.tileDistance({0, 10}), 0.5f); // the edge of the map is a wall
+  EXPECT_FLOAT_EQ(field.tileDistance({20, 15}), 14.5f);
+
+  // edits in place match building the field from scratch, and the exact distance
+  std::mt19937 random(7);
+  for (int i = 0; i < 200; ++i) {
+    const glm::ivec2 cell(random() % 40, random() % 30);
+    walkable.set(cell, not walkable.get(cell));
+    field.update(walkable, cell);
+  }
+  const DistanceField rebuilt(walkable);
+  for (int x = 0; x < 40; ++x) {
+    for (int y = 0; y < 30; ++y) {
+      float exact = std::min({x + 0.5f, 39.5f - x, y + 0.5f, 29.5f - y});
+      for (int ox = 0; ox < 40; ++ox) {
+        for (int oy = 0; oy < 30; ++oy) {
+          if (not walkable.get({ox, oy})) {
+            const glm::vec2 gap = glm::max(glm::abs(glm::vec2(x - ox, y - oy)) - 0.5f, 0.f);
+            exact = std::min(exact, glm::length(gap));
+          }
+        }
+      }
+      EXPECT_FLOAT_EQ(field.tileDistance({x, y}), rebuilt.tileDistance({x, y}));
+      EXPECT_NEAR(field.tileDistance({x, y}), exact, 0.1);
+    }
+  }
+
+  // pushing out leaves a circle just touching the nearest wall
+  BitGrid wall(10, 10, true);
+  wall.set({5, 5}, false);
+  const DistanceField walled(wall);
+  EXPECT_NEAR(walled.pushOut({4.8, 5.5}, 0.45).x, 5 - 0.45, 1e-5);
+  EXPECT_NEAR(walled.sample({5.2, 5.5}).distance, -0.2, 1e-5);
+  EXPECT_EQ(walled.pushOut({2.5, 2.5}, 0.45), glm::vec2(2.5, 2.5));
+}
+
+TEST(LineOfSight, walls) {
+  BitGrid walkable(10, 10, true);
+  EXPECT_TRUE(lineOfSight(walkable, {0.5, 0.5}, {9.5, 7.5}));
+
+  walkable.set({5, 0}, false);
+  walkable.set({5, 1}, false);
+  EXPECT_FALSE(lineOfSight(walkable, {0.5, 0.5}, {9.5, 1.5}));
+  EXPECT_TRUE(lineOfSight(walkable, {0.5, 2.5}, {9.5, 2.5}));
+
+  // a body grazing the end of the wall doesn't fit past it
+  EXPECT_TRUE(lineOfSight(walkable, {0.5, 2.2}, {9.5, 2.2}));
+  EXPECT_FALSE(lineOfSight(walkable, {0.5, 2.2}, {9.5, 2.2}, 0.45));
+}
+
+TEST(LineOfSight, corners) {
+  BitGrid walkable(4, 4, true);
+  walkable.set({1, 0}, false);
+
+  // passes exactly through the corner shared by (0, 0), (1, 0), (0, 1) and (1, 1)
+  EXPECT_FALSE(lineOfSight(walkable, {0.5, 0.5}, {1.5, 1.5}));
+  EXPECT_TRUE(lineOfSight(walkable, {0.5, 1.5}, {1.5, 2.5}));
+}
+
+TEST(LineOfSight, batch) {
+  BitGrid walkable(default_world_size, default_world_size, true);
+  std::mt19937 mt(0);
+  std::uniform_int_distribution<int> cell{0, default_world_size - 1};
+  for (int i = 0; i < 1000; ++i) {
+    walkable.set({cell(mt), cell(mt)}, false);
+  }
+
+  std::uniform_real_distribution<float> coord{0, default_world_size};
+  std::vector<SightQuery> queries;
+  for (int i = 0; i < 1000; ++i) {
+    queries.push_back({{coord(mt), coord(mt)}, {coord(mt), coord(mt)}});
+  }
+
+  std::vector<unsigned char> visible;
+  lineOfSight(walkable, queries, visible, 0.25);
+  ASSERT_EQ(visible.size(), queries.size());
+  for (std::size_t i = 0; i < queries.size(); ++i) {
+    EXPECT_EQ(visible[i], lineOfSight(walkable, queries[i].from, queries[i].to, 0.25));
   }
 }
 
@@ -57,7 +660,7 @@ TEST(Perlin, rangeTest) {
   std::mt19937 mt(0);
   std::uniform_real_distribution<double> dist{-10, 10};
   for (int i = 0; i < 100000; ++i) {
-    double f = p(dist(mt), dist(mt));
+    double f = p.generate(dist(mt), dist(mt));
     min = std::min(min, f);
     max = std::max(max, f);
   }
@@ -65,6 +668,543 @@ TEST(Perlin, rangeTest) {
   std::cout << min << ", " << max << std::endl;
 }
 
+TEST(Perlin, bitIdentical) {
+  PerlinNoise p(42069);
+  p.frequency(1 / 30.).lacunarity(2.5);
+
+  // vector lanes and the scalar tail give exactly the same bits, and match the 3D noise
+  float row[37];
+  for (int y : {-70, 0, 13, 1999}) {
+    p.generateRow<3>(-5, y, 37, row);
+    for (int i = 0; i < 37; ++i) {
+      const float one = p.generate2D<3>(i - 5.f, static_cast<float>(y));
+      ASSERT_EQ(std::memcmp(&row[i], &one, sizeof(float)), 0) << i << ", " << y;
+      EXPECT_NEAR(row[i], p.generate<3>(i - 5, y), 1e-4);
+    }
+  }
+
+  // a map generated in one threaded batch matches one generated a chunk at a time
+  constexpr int size = Region::chunk_size * 8;
+  Region batched(size), single(size);
+  RegionGenerator(7).generate(batched);
+  RegionGenerator(7).generate(single);
+  batched.touch({0, 0}, {size - 1, size - 1});
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      ASSERT_EQ(batched.at({x, y}), single.at({x, y}));
+    }
+  }
+
+  // and tiles come out as the double 3D noise always made them, near the origin or far from it
+  PerlinNoise reference(7);
+  reference.frequency(1 / 30.).lacunarity(2.5);
+  auto expected = [&](glm::ivec2 p) {
+    const double f = reference.generate<3>(p.x, p.y);
+    return f < 0.3 ? Tile::WATER : f < 0.4 ? Tile::SAND : f > 0.88 ? Tile::MOUNTAIN : Tile::GRASS;
+  };
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      if (std::abs(x - size / 2) > 1 || std::abs(y - size / 2) > 1) {
+        ASSERT_EQ(single.at({x, y}), expected({x, y})) << x << ", " << y;
+      }
+    }
+  }
+  Region::Chunk far;
+  for (int origin : {100000, 1000000}) {
+    RegionGenerator(7).fill({origin, origin}, size, far);
+    for (int i = 0; i < Region::chunk_size * Region::chunk_size; ++i) {
+      const glm::ivec2 p(origin + i % Region::chunk_size, origin + i / Region::chunk_size);
+      ASSERT_EQ(far[i], expected(p)) << p.x << ", " << p.y;
+    }
+  }
+}
+
+TEST(Definitions, load) {
+  std::istringstream good("# comment\n"
+                          "\n"
+                          "tile SAND moveCost=4 color=1,0.5,0,1 # trailing\n"
+                          "structure WALL health=800\n"
+                          "unit ENEMY attackRange=2.5\n");
+  loadDefinitions(good);
+  EXPECT_EQ(TileProperties::of(Tile::SAND).moveCost, 4);
+  EXPECT_EQ(TileProperties::of(Tile::SAND).color, glm::vec4(1.f, 0.5f, 0.f, 1.f));
+  EXPECT_TRUE(TileProperties::of(Tile::SAND).walkable); // left out, so unchanged
+  EXPECT_EQ(StructureProperties::of(StructureType::WALL).health, 800);
+  EXPECT_EQ(UnitProperties::of(UnitType::ENEMY).attackRange, 2.5f);
+  EXPECT_EQ(UnitProperties::longestAttackRange(), UnitProperties::of(UnitType::UNIT).attackRange);
+
+  // a bad line anywhere throws and changes nothing, not even the lines before it
+  for (const char* bad : {"tile GRASS moveCost=7\ntile LAVA moveCost=2\n",
+                          "tile GRASS moveCost=7\ntile SAND moveCost=0\n",
+                          "tile GRASS moveCost=7\nunit UNIT speed=2\n",
+                          "tile GRASS moveCost=7\nunit UNIT health=lots\n",
+                          "tile GRASS moveCost=7\ntrap GRASS\n"}) {
+    std::istringstream in(bad);
+    EXPECT_THROW(loadDefinitions(in), std::runtime_error) << bad;
+    EXPECT_EQ(TileProperties::of(Tile::GRASS).moveCost, base_move_cost);
+  }
+
+  // the shipped file holds the built-in values
+  TileProperties::reset();
+  StructureProperties::reset();
+  UnitProperties::reset();
+  EXPECT_TRUE(loadDefinitionsFile("data/definitions.txt"));
+  EXPECT_EQ(TileProperties::of(Tile::SAND).moveCost, 3);
+  EXPECT_EQ(StructureProperties::of(StructureType::WALL).health, 500);
+  EXPECT_EQ(UnitProperties::of(UnitType::ENEMY).attackRange, 1.5f);
+  EXPECT_FALSE(loadDefinitionsFile("data/no-such-file.txt"));
+
+  TileProperties::reset();
+  StructureProperties::reset();
+  UnitProperties::reset();
+}
+
+TEST(Grid, blockLayout) {
+  BlockGrid<int> blocks(19, 21, -1);
+  Grid<int> rows(19, 21, -1);
+  int n = 0;
+  for (int y = 0; y < 21; ++y) {
+    for (int x = 0; x < 19; ++x) {
+      blocks[{x, y}] = rows[{x, y}] = n++;
+    }
+  }
+
+  // rectangles are visited a block at a time, but reach every cell once
+  long sum = 0;
+  int visits = 0;
+  blocks.forEach({-3, 5}, {12, 40}, [&](glm::ivec2 p, int& cell) {
+    EXPECT_EQ(cell, rows[p]);
+    sum += cell;
+    ++visits;
+  });
+  EXPECT_EQ(visits, 13 * 16);
+  long expected = 0;
+  for (int y = 5; y < 21; ++y) {
+    for (int x = 0; x <= 12; ++x) {
+      expected += rows[{x, y}];
+    }
+  }
+  EXPECT_EQ(sum, expected);
+
+  int neighbors = 0;
+  blocks.forEachNeighbor({0, 20}, [&](glm::ivec2 p, int& cell) {
+    EXPECT_EQ(cell, rows[p]);
+    ++neighbors;
+  });
+  EXPECT_EQ(neighbors, 3);
+
+  blocks.fill({1, 1}, {2, 2}, -1);
+  EXPECT_EQ((blocks[{2, 2}]), -1);
+  EXPECT_EQ((blocks[{3, 2}]), (rows[{3, 2}]));
+}
+
+// a brushfire wave out from scattered seeds, the access pattern of the distance field and path
+// search, timed over both layouts
+template <typename G>
+double brushfire(G& distance, const std::vector<glm::ivec2>& seeds) {
+  const auto begin = std::chrono::steady_clock::now();
+  const glm::ivec2 neighbors[] = {{1, 0},  {-1, 0}, {0, 1},  {0, -1},
+                                  {1, 1},  {1, -1}, {-1, 1}, {-1, -1}};
+  std::vector<glm::ivec2> wave(seeds);
+  for (const glm::ivec2& seed : seeds) {
+    distance[seed] = 0;
+  }
+  for (std::size_t head = 0; head < wave.size(); ++head) {
+    const glm::ivec2 p = wave[head];
+    for (const glm::ivec2& d : neighbors) {
+      const glm::ivec2 n = p + d;
+      if (distance.inBounds(n) && distance[p] + 1 < distance[n]) {
+        distance[n] = distance[p] + 1;
+        wave.push_back(n);
+      }
+    }
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// a timing, not a check, so it only runs when asked for with --gtest_also_run_disabled_tests
+TEST(Grid, DISABLED_blockLayoutBenchmark) {
+  constexpr int size = 2048;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> coord(0, size - 1);
+
+  // one front, like a path search, then many, like the distance field
+  for (int seedCount : {1, 64}) {
+    std::vector<glm::ivec2> seeds;
+    for (int i = 0; i < seedCount; ++i) {
+      seeds.push_back({coord(rng), coord(rng)});
+    }
+
+    Grid<int> rows(size, size, std::numeric_limits<int>::max());
+    BlockGrid<int> blocks(size, size, std::numeric_limits<int>::max());
+    const double rowTime = brushfire(rows, seeds);
+    const double blockTime = brushfire(blocks, seeds);
+    for (int y = 0; y < size; ++y) {
+      for (int x = 0; x < size; ++x) {
+        ASSERT_EQ((rows[{x, y}]), (blocks[{x, y}]));
+      }
+    }
+
+    std::cout << seedCount << " seeds: rows " << rowTime << "s, blocks " << blockTime << "s"
+              << std::endl;
+  }
+}
+
+// a component no game entity has, so ProbeSystem only ever sees what a test gives it
+struct ProbeComponent : public ECS::Component {
+  static constexpr ECS::ComponentTypeId type = 100;
+};
+constexpr ECS::ComponentTypeId ProbeComponent::type;
+
+// records the dt of every visit to each of its entities
+class ProbeSystem : public ECS::System {
+public:
+  std::map<ECS::Entity, std::vector<float>> visits;
+
+  ProbeSystem(GameState& gameState, unsigned interval = 1) : ECS::System(gameState) {
+    ECS::ComponentTypeSet requiredComponents;
+    requiredComponents.insert(ProbeComponent::type);
+
+    setRequiredComponents(std::move(requiredComponents));
+    setUpdateInterval(interval);
+  }
+
+  void updateEntity(float dt, ECS::Entity entity) override {
+    visits[entity].push_back(dt);
+  }
+};
+
+TEST(System, sleepAndWake) {
+  createComponentStores();
+  ECS::Manager::createComponentStore<ProbeComponent>();
+  ResourceType resources = init_resource_bal;
+  bool debug = false;
+  World world(64, resources);
+  GameState gameState(world, resources, debug);
+  auto* probe = new ProbeSystem(gameState);
+  ECS::Manager::addSystem(ECS::System::Ptr(probe)); // so Manager::wake reaches it
+
+  const glm::vec2 pos = centerOfTile(world.centerCell());
+  ASSERT_TRUE(world.addUnit(pos));
+  const ECS::Entity unit = world.units().back();
+  ECS::Manager::addComponent(unit, ProbeComponent());
+  ECS::Manager::registerEntity(unit);
+
+  probe->update(sim_step);
+  EXPECT_EQ(probe->visits[unit].size(), 1u);
+
+  // asleep from the next update on, and skipped by it
+  probe->sleep(unit);
+  EXPECT_TRUE(probe->isAwake(unit));
+  probe->update(sim_step);
+  EXPECT_FALSE(probe->isAwake(unit));
+  EXPECT_TRUE(probe->hasEntity(unit));
+  EXPECT_EQ(probe->visits[unit].size(), 1u);
+
+  EXPECT_EQ(ECS::Manager::wake(unit), 1u);
+  EXPECT_EQ(ECS::Manager::wake(unit), 0u);
+  probe->update(sim_step);
+  EXPECT_EQ(probe->visits[unit].size(), 2u);
+
+  // anything happening nearby wakes it too, but nothing far away does
+  probe->sleep(unit);
+  probe->update(sim_step);
+  world.wakeAround(pos + glm::vec2(World::wakeRadius() + 1, 0));
+  EXPECT_FALSE(probe->isAwake(unit));
+  world.wakeAround(pos + glm::vec2(1, 0));
+  EXPECT_TRUE(probe->isAwake(unit));
+
+  // deleting a sleeping entity takes it out of the sleeping set too
+  probe->sleep(unit);
+  probe->update(sim_step);
+  ASSERT_EQ(probe->sleepingEntities().count(unit), 1u);
+  EXPECT_TRUE(world.remove(unit));
+  ECS::Manager::update(sim_step);
+  EXPECT_FALSE(probe->hasEntity(unit));
+  EXPECT_EQ(probe->sleepingEntities().count(unit), 0u);
+}
+
+TEST(System, updateInterval) {
+  ResourceType resources = init_resource_bal;
+  bool debug = false;
+  World world(64, resources);
+  GameState gameState(world, resources, debug);
+
+  // as in TargetingSystem; entities don't have to exist for a System that doesn't look them up
+  constexpr unsigned interval = 3;
+  ProbeSystem probe(gameState, interval);
+  for (ECS::Entity e = 1; e <= 7; ++e) {
+    probe.registerEntity(e);
+  }
+
+  // each lap of interval updates visits every entity exactly once, about 1/interval per update
+  for (unsigned lap = 1; lap <= 4; ++lap) {
+    for (unsigned i = 0; i < interval; ++i) {
+      const std::size_t visited = probe.update(sim_step);
+      EXPECT_GE(visited, 7u / interval);
+      EXPECT_LE(visited, 7u / interval + 1);
+    }
+    for (ECS::Entity e = 1; e <= 7; ++e) {
+      ASSERT_EQ(probe.visits[e].size(), lap);
+    }
+  }
+
+  // with the time since that entity's last visit
+  for (ECS::Entity e = 1; e <= 7; ++e) {
+    EXPECT_NEAR(probe.visits[e].back(), interval * sim_step, 1e-6);
+  }
+
+  // but one that registers or wakes between visits only gets the time since then
+  const auto firstVisit = [&](ECS::Entity e) {
+    const std::size_t before = probe.visits[e].size();
+    unsigned frames = 0;
+    while (probe.visits[e].size() == before) {
+      probe.update(sim_step);
+      ++frames;
+    }
+    EXPECT_LE(frames, interval);
+    EXPECT_NEAR(probe.visits[e].back(), frames * sim_step, 1e-6);
+    return frames;
+  };
+  probe.registerEntity(8);
+  EXPECT_LT(firstVisit(8), interval);
+
+  probe.sleep(1);
+  const std::size_t awake = probe.visits[1].size();
+  for (unsigned i = 0; i < 2 * interval; ++i) {
+    probe.update(sim_step);
+  }
+  EXPECT_EQ(probe.visits[1].size(), awake);
+  probe.wake(1);
+  EXPECT_LT(firstVisit(1), interval);
+
+  // and from then on the whole interval again
+  for (unsigned i = 0; i < interval; ++i) {
+    probe.update(sim_step);
+  }
+  for (ECS::Entity e : {1, 8}) {
+    EXPECT_NEAR(probe.visits[e].back(), interval * sim_step, 1e-6);
+  }
+}
+
+TEST(FixedStep, stepsAndBlending) {
+  FixedStep clock;
+  EXPECT_EQ(clock.advance(sim_step * 0.5f), 0);
+  EXPECT_NEAR(clock.alpha(), 0.5, 1e-3);
+  EXPECT_EQ(clock.advance(sim_step * 2), 2);
+  EXPECT_NEAR(clock.alpha(), 0.5, 1e-3);
+
+  // a long stall runs max_sim_steps, and what's left past a whole step is dropped
+  EXPECT_EQ(clock.advance(sim_step * (max_sim_steps * 4 + 0.25f)), max_sim_steps);
+  EXPECT_NEAR(clock.alpha(), 0.75, 1e-3);
+  EXPECT_EQ(clock.advance(sim_step * 0.5f), 1);
+  EXPECT_NEAR(clock.alpha(), 0.25, 1e-3);
+
+  // frames in between draw from where a step started towards where it ended
+  ResourceType resources = 0;
+  World world(64, resources);
+  TransformComponent transform(world, {2, 2}, 3);
+  transform.snapshot();
+  transform.pos = {4, 3};
+  transform.rot = -3;
+  EXPECT_EQ(transform.renderPos(0), glm::vec2(2, 2));
+  EXPECT_EQ(transform.renderPos(1), glm::vec2(4, 3));
+  EXPECT_NEAR(transform.renderPos(clock.alpha()).x, 2.5, 1e-3);
+  EXPECT_NEAR(transform.renderPos(clock.alpha()).y, 2.25, 1e-3);
+  EXPECT_NEAR(transform.renderRot(0.5), 3 + (glm::two_pi<float>() - 6) / 2, 1e-4); // short way
+}
+
+TEST(UnitSelectSystem, boxBetweenSteps) {
+  createComponentStores();
+  ResourceType resources = init_resource_bal;
+  bool debug = false;
+  World world(64, resources);
+  GameState gameState(world, resources, debug);
+  gameState._mode = ControlMode::NONE;
+  View view;
+  UnitSelectSystem select(gameState, view);
+
+  const glm::vec2 center = centerOfTile(world.centerCell());
+  ASSERT_TRUE(world.addUnit(center));
+  ASSERT_TRUE(world.addUnit(center + glm::vec2(2, 0)));
+  ASSERT_TRUE(world.addUnit(center + glm::vec2(6, 6)));
+  const std::vector<ECS::Entity> units = world.units();
+
+  // the whole drag happens between two steps, so no update sees the box
+  ECS::EventManager::event(new MouseDownEvent(GLFW_MOUSE_BUTTON_1, center.x - 1, center.y - 1));
+  ECS::EventManager::event(new MouseMoveEvent(center.x + 3, center.y + 1));
+  ECS::EventManager::event(new MouseUpEvent(GLFW_MOUSE_BUTTON_1, center.x + 3, center.y + 1));
+  ECS::EventManager::update();
+
+  EXPECT_TRUE(ECS::Manager::getComponent<SelectableComponent>(units[0]).selected);
+  EXPECT_TRUE(ECS::Manager::getComponent<SelectableComponent>(units[1]).selected);
+  EXPECT_FALSE(ECS::Manager::getComponent<SelectableComponent>(units[2]).selected);
+}
+
+TEST(UnitCollisionSystem, idleMoversSleep) {
+  createComponentStores();
+  ResourceType resources = init_resource_bal;
+  bool debug = false;
+  World world(64, resources);
+  GameState gameState(world, resources, debug);
+  UnitCollisionSystem collision(gameState);
+  const glm::ivec2 cell = world.centerCell();
+  for (int y = -4; y <= 4; ++y) {
+    for (int x = -4; x <= 4; ++x) {
+      world.setCell(cell + glm::ivec2(x, y), Tile::GRASS);
+    }
+  }
+
+  const glm::vec2 center = centerOfTile(cell);
+  ASSERT_TRUE(world.addUnit(center));
+  ASSERT_TRUE(world.addUnit(center + glm::vec2(2, 0)));
+  const ECS::Entity resting = world.units()[0];
+  const ECS::Entity walker = world.units()[1];
+  collision.registerEntity(resting);
+  collision.registerEntity(walker);
+
+  // nothing overlaps, so both settle and later updates visit nobody
+  collision.update(sim_step);
+  EXPECT_EQ(collision.update(sim_step), 0u);
+  EXPECT_EQ(collision.sleepingEntities().size(), 2u);
+
+  // an order wakes the walker, which walks onto the resting one without leaving its bucket
+  ECS::Manager::getComponent<MotionComponent>(walker).hasTarget = true;
+  collision.wake(walker);
+  ECS::Manager::getComponent<TransformComponent>(walker).pos = center + glm::vec2(0.3, 0);
+  collision.update(sim_step);
+  EXPECT_TRUE(collision.isAwake(resting));
+  EXPECT_LT(ECS::Manager::getComponent<TransformComponent>(resting).pos.x, center.x);
+
+  // once the walker stops and they're apart, both go back to sleep
+  ECS::Manager::getComponent<MotionComponent>(walker).hasTarget = false;
+  for (int i = 0; i < 20 && collision.sleepingEntities().size() < 2; ++i) {
+    collision.update(sim_step);
+  }
+  EXPECT_EQ(collision.sleepingEntities().size(), 2u);
+}
+
+// keeps where every DeathEvent dispatched while it exists happened
+struct DeathRecorder : public ECS::EventSubscriber<DeathEvent> {
+  std::vector<glm::vec2> deaths;
+
+  DeathRecorder() {
+    ECS::EventManager::connect<DeathEvent>(this);
+  }
+  ~DeathRecorder() {
+    ECS::EventManager::disconnect<DeathEvent>(this);
+  }
+
+  void receive(const DeathEvent& e) override {
+    deaths.push_back(e.pos);
+  }
+};
+
+TEST(BattleSystem, mutualKill) {
+  createComponentStores();
+  ResourceType resources = init_resource_bal;
+  bool debug = false;
+  World world(64, resources);
+  GameState gameState(world, resources, debug);
+  BattleSystem battle(gameState);
+  const glm::vec2 unitPos = centerOfTile(world.centerCell());
+  const glm::vec2 enemyPos = unitPos + glm::vec2(1, 0);
+
+  // a unit and an enemy on their last hit point shoot each other in the same step, once with
+  // the unit visited first and once with the enemy
+  for (bool unitFirst : {true, false}) {
+    ASSERT_TRUE(unitFirst ? world.addUnit(unitPos) : world.addEnemy(enemyPos));
+    ASSERT_TRUE(unitFirst ? world.addEnemy(enemyPos) : world.addUnit(unitPos));
+    const ECS::Entity unit = world.units().back();
+    const ECS::Entity enemy = world.enemies().back();
+    ASSERT_EQ(unit < enemy, unitFirst);
+
+    for (ECS::Entity e : {unit, enemy}) {
+      ECS::Manager::getComponent<HealthComponent>(e).health = 1;
+      battle.registerEntity(e);
+    }
+    ECS::Manager::getComponent<AttackComponent>(unit).target = enemy;
+    ECS::Manager::getComponent<AttackComponent>(enemy).target = unit;
+
+    DeathRecorder recorder;
+    battle.update(sim_step);
+    ECS::EventManager::update();
+    ECS::Manager::update(sim_step); // carries out the deletes
+
+    // both die, each once, and neither is left anywhere the world looks
+    std::vector<glm::vec2> deaths = recorder.deaths;
+    std::sort(deaths.begin(), deaths.end(),
+              [](glm::vec2 a, glm::vec2 b) { return a.x < b.x; });
+    EXPECT_EQ(deaths, (std::vector<glm::vec2>{unitPos, enemyPos}));
+    for (ECS::Entity e : {unit, enemy}) {
+      EXPECT_FALSE(ECS::Manager::hasEntity(e));
+      EXPECT_EQ(world.roster().factionOf(e), Faction::NONE);
+      battle.unregisterEntity(e);
+    }
+    EXPECT_TRUE(world.units().empty());
+    EXPECT_TRUE(world.enemies().empty());
+    EXPECT_EQ(world.spatialIndex().nearest(unitPos, 5, Faction::UNIT | Faction::ENEMY),
+              ECS::InvalidEntityId);
+  }
+}
+
+TEST(World, removeMany) {
+  createComponentStores();
+  ResourceType resources = 100 * init_resource_bal;
+  bool debug = false;
+  World world(64, resources);
+  GameState gameState(world, resources, debug);
+
+  const glm::ivec2 center = world.centerCell();
+  std::vector<ECS::Entity> doomed;
+  for (int x = 3; x <= 5; ++x) {
+    ASSERT_TRUE(world.addStructure(center + glm::ivec2(x, 0)));
+    doomed.push_back(world.structureAt(center + glm::ivec2(x, 0)));
+  }
+  ASSERT_TRUE(world.addUnit(centerOfTile(center - 4)));
+  auto& motion = ECS::Manager::getComponent<MotionComponent>(world.units().back());
+  motion.follow({center - 3, center - 2}, centerOfTile(center - 4));
+
+  // every structure goes at once, and the movers are sent to find a way again
+  EXPECT_EQ(world.remove(doomed), 3u);
+  for (int x = 3; x <= 5; ++x) {
+    EXPECT_EQ(world.structureAt(center + glm::ivec2(x, 0)), ECS::InvalidEntityId);
+  }
+  EXPECT_TRUE(motion.path.empty());
+  EXPECT_TRUE(motion.hasTarget);
+  EXPECT_EQ(world.remove(doomed), 0u);
+  ECS::Manager::update(sim_step);
+}
+
+TEST(FactionRosterSystem, followsRegistration) {
+  createComponentStores();
+  ResourceType resources = init_resource_bal;
+  bool debug = false;
+  World world(64, resources);
+  GameState gameState(world, resources, debug);
+
+  // an entity joins its faction once it registers, whoever made it
+  const ECS::Entity enemy = ECS::Manager::createEntity();
+  ECS::Manager::addComponent(enemy, FactionComponent(Faction::ENEMY));
+  EXPECT_TRUE(world.enemies().empty());
+  ECS::Manager::registerEntity(enemy);
+  EXPECT_EQ(world.enemies(), std::vector<ECS::Entity>{enemy});
+
+  // one the World removes stays until the Manager deletes it at the end of the update
+  ASSERT_TRUE(world.addUnit(centerOfTile(world.centerCell())));
+  const ECS::Entity unit = world.units().back();
+  EXPECT_TRUE(world.remove(unit));
+  EXPECT_FALSE(world.remove(unit));
+  EXPECT_EQ(world.roster().factionOf(unit), Faction::UNIT);
+  ECS::Manager::update(sim_step);
+  EXPECT_EQ(world.roster().factionOf(unit), Faction::NONE);
+  EXPECT_TRUE(world.units().empty());
+
+  // and clearing the Manager leaves no one
+  ECS::Manager::clear();
+  EXPECT_EQ(world.roster().size(), 0u);
+}
+
 // TEST(Pathing, constructor) {
 //   std::array<int, 100> a;
 //   a.fill(7);
@@ -1,32 +1,48 @@
 
 #include "Tile.h"
 
+namespace {
+
 // clang-format off
-const std::unordered_map<Tile, const TileType> TileProperties::_data{
-    {Tile::NONE, TileType{
+// const rather than constexpr: glm only makes vec4 constexpr when it isn't using SIMD
+const std::array<TileType, tile_count> tile_defaults{{
+    /* NONE */ TileType{
         .color = {1.f, 0.f, 1.f, 1.f}, 
         .walkable = false,
+        .moveCost = base_move_cost, // unused while not walkable
         .texOffset = 0, // TODO: texture
-        }},
-    {Tile::GRASS, TileType{
+        },
+    /* GRASS */ TileType{
         .color = {0.3f, 0.8f, 0.2f, 1.f}, 
         .walkable = true,
+        .moveCost = base_move_cost,
         .texOffset = 1,
-        }},
-    {Tile::SAND, TileType{
+        },
+    /* SAND */ TileType{
         .color = {0.6f, 0.6f, 0.4f, 1.f},
         .walkable = true,
+        .moveCost = 3,
         .texOffset = 3,
-    }},
-    {Tile::WATER, TileType{
+    },
+    /* WATER */ TileType{
         .color = {0.1f, 0.2f, 0.7f, 1.f}, 
         .walkable = false,
+        .moveCost = base_move_cost, // unused while not walkable
         .texOffset = 4,
-        }},
-    {Tile::MOUNTAIN, TileType{
+        },
+    /* MOUNTAIN */ TileType{
         .color = {0.55f, 0.275f, 0.08f, 1.f},
         .walkable = false,
+        .moveCost = base_move_cost, // unused while not walkable
         .texOffset = 5,
     }}
     };
 // clang-format on
+
+} // namespace
+
+std::array<TileType, tile_count> TileProperties::_data = tile_defaults;
+
+void TileProperties::reset() {
+  _data = tile_defaults;
+}
@@ -1,32 +1,68 @@
 #pragma once
 
+#include "Config.h"
+
 #include <glm/glm.hpp>
-#include <unordered_map>
 
-enum class Tile { NONE, GRASS, SAND, WATER, MOUNTAIN };
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 
-namespace std {
+enum class Tile : std::uint8_t { NONE, GRASS, SAND, WATER, MOUNTAIN };
+constexpr std::size_t tile_count = static_cast<std::size_t>(Tile::MOUNTAIN) + 1;
 
-template <>
-struct hash<Tile> {
-  size_t operator()(const Tile& t) const {
-    return std::hash<int>()(static_cast<int>(t));
-  }
-}
-;
-} // namespace std
+// moveCost of ordinary ground. A tile with moveCost c is crossed at base_move_cost / c of a
+// mover's full speed, and costs c per unit of distance when planning paths.
+constexpr int base_move_cost = 2;
 
 struct TileType {
   glm::vec4 color;
   bool walkable;
+  int moveCost;
   int texOffset;
 };
 
+/**
+ * @brief Every TileType, indexed by Tile
+ * @detail Starts out as the built-in table and can be changed at startup by loadDefinitions.
+ */
 class TileProperties {
-  static const std::unordered_map<Tile, const TileType> _data;
+  static std::array<TileType, tile_count> _data;
 
 public:
   static const TileType& of(Tile t) {
-    return TileProperties::_data.at(t);
+    return _data[static_cast<std::size_t>(t)];
+  }
+
+  static void set(Tile t, const TileType& type) {
+    _data[static_cast<std::size_t>(t)] = type;
+  }
+
+  /// back to the built-in table
+  static void reset();
+
+  /// the smallest moveCost of any walkable tile, for admissible path cost estimates
+  static int cheapestMoveCost() {
+    int result = base_move_cost;
+    for (const TileType& type : _data) {
+      if (type.walkable) {
+        result = std::min(result, type.moveCost);
+      }
+    }
+    return result;
   }
 };
+
+/// the tile under a point in world coordinates
+inline glm::ivec2 mapCoordsToTile(glm::vec2 coords) {
+  return glm::ivec2(static_cast<int>(coords.x / tile_size), static_cast<int>(coords.y / tile_size));
+}
+
+inline glm::vec2 centerOfTile(glm::vec2 p) {
+  return glm::floor(p) + glm::vec2(0.5 * tile_size, 0.5 * tile_size);
+}
+
+inline glm::vec2 centerOfTile(glm::ivec2 p) {
+  return glm::vec2(p.x, p.y) + glm::vec2(0.5 * tile_size, 0.5 * tile_size);
+}
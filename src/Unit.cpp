@@ -1,18 +1,48 @@
 #include "Unit.h"
-#include "Game.h"
+#include "Tile.h"
 
 #include "Path.h"
 #include "World.h"
 
+namespace {
+
+// clang-format off
+constexpr std::array<UnitData, unit_type_count> unit_defaults{{
+    /* UNIT */ UnitData{
+        .health = 150,
+        .strength = 25,
+        .attackRange = 3.5f,
+        .attackCooldown = 1.f,
+        .cost = 25
+    },
+    /* ENEMY */ UnitData{
+        .health = 100,
+        .strength = 25,
+        .attackRange = 1.5f,
+        .attackCooldown = 1.f,
+        .cost = 0
+    }
+}};
+// clang-format on
+
+} // namespace
+
+std::array<UnitData, unit_type_count> UnitProperties::_data = unit_defaults;
+
+void UnitProperties::reset() {
+  _data = unit_defaults;
+}
+
 Unit::Unit(glm::vec2 pos, World& world) : _target(pos), id(ECS::Manager::createEntity()) {
 
   ECS::Entity idCopy = id; // have to do this because this pointer gets moved around
 
   ECS::Manager::addComponent<TransformComponent>(id, TransformComponent(world, pos, 0.f));
   ECS::Manager::addComponent<MotionComponent>(id, MotionComponent());
-  ECS::Manager::addComponent<HealthComponent>(id, HealthComponent(max_health));
-  ECS::Manager::addComponent<AttackComponent>(id,
-                                              AttackComponent(strength, radius, attackCooldown));
+  const UnitData& data = UnitProperties::of(UnitType::UNIT);
+  ECS::Manager::addComponent<HealthComponent>(id, HealthComponent(data.health));
+  ECS::Manager::addComponent<AttackComponent>(
+      id, AttackComponent(data.strength, data.attackRange, data.attackCooldown));
 
   ECS::Manager::addComponent<SelectableComponent>(id, SelectableComponent());
   ECS::Manager::addComponent<CommandableComponent>(
@@ -21,8 +51,10 @@ Unit::Unit(glm::vec2 pos, World& world) : _target(pos), id(ECS::Manager::createE
         auto& centroid = ECS::Manager::getComponent<SelectableComponent>(idCopy).selectionCentroid;
         glm::vec2 offset = pos - centroid;
         ECS::Manager::getComponent<MotionComponent>(idCopy).pathTo(targetPos + offset);
+        ECS::Manager::wake(idCopy);
       }));
   ECS::Manager::addComponent<LightComponent>(id, LightComponent({0.f, 0.f, 1.f, 1.f}, 1.f));
+  ECS::Manager::addComponent<FactionComponent>(id, FactionComponent(Faction::UNIT));
   ECS::Manager::registerEntity(id);
 }
 
@@ -38,12 +70,16 @@ Path& Unit::path() const {
   return ECS::Manager::getComponent<MotionComponent>(id).path;
 }
 
+std::size_t Unit::waypoint() const {
+  return ECS::Manager::getComponent<MotionComponent>(id).waypoint;
+}
+
 void Unit::repath() const {
   return ECS::Manager::getComponent<MotionComponent>(id).repath();
 }
 
 glm::ivec2 Unit::currentTarget() const {
-  return ECS::Manager::getComponent<MotionComponent>(id).currentTarget.operator*();
+  return ECS::Manager::getComponent<MotionComponent>(id).currentWaypoint();
 }
 
 HealthValue Unit::health() const {
@@ -5,10 +5,11 @@
 #include "Components.h"
 
 #include "Config.h"
-#include "Graphics.h"
 #include "Path.h"
+#include "UnitType.h"
 
 class World;
+class View;
 
 class Unit {
   glm::vec2 _target;
@@ -17,12 +18,9 @@ public:
   const ECS::Entity id;
 
   constexpr static float unit_size = 0.5f * tile_size;
+  // how far a body reaches from its center, both against tiles and when planning paths
+  constexpr static float body_radius = unit_size * 0.9f;
   constexpr static float unit_speed = 2.f;
-  constexpr static HealthValue max_health = 150;
-  constexpr static StrengthValue strength = 25;
-  constexpr static float attackCooldown = 1.f;
-  constexpr static float radius = 3.5f;
-  constexpr static ResourceType cost = 25;
 
   Unit(glm::vec2 pos, World&);
 
@@ -35,16 +33,10 @@ public:
   glm::vec2 pos() const;
   bool selected() const;
   Path& path() const;
+  std::size_t waypoint() const;
   glm::ivec2 currentTarget() const;
   void repath() const;
   HealthValue health() const;
 
-  static void holo(View& view, glm::vec2 curr) {
-    CircleBatch()
-        .add()
-        .position(curr)
-        .size({tile_size, tile_size})
-        .color({1, 0.5, 0.5, 0.5})
-        .draw(view);
-  }
+  static void holo(View& view, glm::vec2 curr);
 };
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Config.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+enum class UnitType { UNIT, ENEMY };
+constexpr std::size_t unit_type_count = static_cast<std::size_t>(UnitType::ENEMY) + 1;
+
+struct UnitData {
+  HealthValue health;
+  StrengthValue strength;
+  float attackRange;
+  float attackCooldown; // seconds between attacks
+  ResourceType cost;    // to recruit one; enemies aren't recruited
+};
+
+/**
+ * @brief Every UnitData, indexed by UnitType
+ * @detail Starts out as the built-in table and can be changed at startup by loadDefinitions.
+ */
+class UnitProperties {
+  static std::array<UnitData, unit_type_count> _data;
+
+public:
+  static const UnitData& of(UnitType t) {
+    return _data[static_cast<std::size_t>(t)];
+  }
+
+  static void set(UnitType t, const UnitData& data) {
+    _data[static_cast<std::size_t>(t)] = data;
+  }
+
+  /// back to the built-in table
+  static void reset();
+
+  static float longestAttackRange() {
+    float result = 0;
+    for (const UnitData& data : _data) {
+      result = std::max(result, data.attackRange);
+    }
+    return result;
+  }
+};
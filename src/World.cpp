@@ -1,156 +1,32 @@
 #include "World.h"
-#include "Game.h"
-#include "Graphics.h"
 #include "Unit.h"
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/string_cast.hpp>
+constexpr float World::wake_margin;
 
-#include <glm/trigonometric.hpp>
-
-// clang-format off
-void mat4_print(glm::mat4 m) {
-  for (int i = 0; i < 4; ++i) {
-    for (int j = 0; j < 4; ++j) {
-      std::cout << m[j][i] << "  ";
-    }
-    std::cout << std::endl;
-  }
-}
-// clang-format on
-
-void World::_drawUnits(TextureBatch& batch) const {
-  const glm::vec4 selectedCol{.53, .53, .82, 1}, unselectedCol{.2, .4, .6, 1},
-      attackingColor{1, 1, 1, 1};
-
-  // clang-format off
-  for (auto& u : _units) {
-    float attackTimer = ECS::Manager::getComponent<AttackComponent>(u.id).attackTimer;
-    
-    //TODO: make bullets flash instead of selection
-
-    float angle = ECS::Manager::getComponent<TransformComponent>(u.id).rot;
-
-    auto baseColor = unselectedCol;
-    if (u.selected()) {
-      baseColor = selectedCol;
-    } else if (attackTimer < muzzleFlashTime) {
-      baseColor = attackingColor;
-    }
-    
-    TextureBatch::Instance inst;
-    inst.pos = u.pos();
-    inst.size = {tile_size, tile_size};
-    inst.aColor = baseColor;
-    inst.rotation = angle;
-    batch.add(std::move(inst));
-  }
-  // clang-format on
-}
-
-void World::_drawEnemies(TextureBatch& batch) const {
-  const glm::vec4 enemyCol{.85, .36, .22, 1}, attackingColor{1, 1, 1, 1};
-
-  // clang-format off
-  for (auto& e : _enemies) {
-    float attackTimer = ECS::Manager::getComponent<AttackComponent>(e.id).attackTimer;
-
-    float angle = ECS::Manager::getComponent<TransformComponent>(e.id).rot;
-
-    auto baseColor = enemyCol;
-    if (attackTimer < muzzleFlashTime) {
-      baseColor = attackingColor;
-    }
-
-    TextureBatch::Instance inst;
-    inst.pos = e.pos();
-    inst.size = {tile_size, tile_size};
-    inst.aColor = baseColor;
-    inst.rotation = angle;
-    batch.add(std::move(inst));
-  }
-  // clang-format on
-}
-
-void World::_drawDebug(View& view) const {
-  RectangleBatch rectangles;
-
-  constexpr float pathMarkerSize = 0.8;
-  glm::vec2 pathTileSize(tile_size * pathMarkerSize, tile_size * pathMarkerSize);
-
-  glm::vec2 pathTileOffset(0.5 * pathMarkerSize * tile_size, 0.5 * pathMarkerSize * tile_size);
-  pathTileOffset -= glm::vec2(0.5, 0.5) * (tile_size * pathMarkerSize);
-
-  for (auto& e : _enemies) {
-    auto& path = e.path();
-    for (auto p : path) {
-      rectangles.add()
-          .position(Game::centerOfTile(p) - pathTileOffset)
-          .size(pathTileSize)
-          .color({1, 0, 0, 0.3});
-    }
-
-    if (not path.empty()) {
-      auto target = path.front();
-      rectangles.add()
-          .position(Game::centerOfTile(target) - pathTileOffset)
-          .size(pathTileSize)
-          .color({0, 0, 1, 0.3});
-
-      LineBatch()
-          .add()
-          .points(e.pos(), Game::centerOfTile(target))
-          .lineWidth(0.2)
-          .color({1, 0, 1, 1})
-          .draw(view);
-    }
-  }
-
-  for (auto& u : _units) {
-    auto& path = u.path();
-    for (auto p : path) {
-      rectangles.add()
-          .position(Game::centerOfTile(p) - pathTileOffset)
-          .size(pathTileSize)
-          .color({1, 0, 0, 0.3});
-    }
-
-    if (not path.empty()) {
-      auto target = path.front();
-      rectangles.add()
-          .position(Game::centerOfTile(target) - pathTileOffset)
-          .size(pathTileSize)
-          .color({0, 0, 1, 0.3});
-    }
-  }
-  rectangles.draw(view);
-}
-
-void World::_drawStructures(TextureBatch& batch) const {
-  const glm::vec2 offset(-tile_size * 0.5, -tile_size * 0.5);
-
-  for (const auto& structure : _structures) {
-    TextureBatch::Instance inst;
-    inst.pos = structure.pos() * tile_size - offset;
-    inst.size = {tile_size, tile_size};
-    inst.texOffset = static_cast<float>(structure.texOffset); 
-    batch.add(std::move(inst));
-  }
+void World::wakeAround(glm::vec2 pos) {
+  const Faction everyone = Faction::UNIT | Faction::ENEMY | Faction::STRUCTURE;
+  _spatialIndex.queryRadius(pos, wakeRadius(), everyone, [](const SpatialIndex::Item& item) {
+    ECS::Manager::wake(item.entity);
+  });
 }
 
 bool World::addUnit(glm::vec2 pos) {
   if (not _region.inBounds(pos)) {
     return false;
   }
+  _touchAround(mapCoordsToTile(pos));
 
-  if (_resources < Unit::cost) {
+  const ResourceType cost = UnitProperties::of(UnitType::UNIT).cost;
+  if (_resources < cost) {
     return false;
   }
 
   // Subtract the cost from the player's resource account
-  _resources -= Unit::cost;
+  _resources -= cost;
 
-  _units.emplace_back(pos, *this);
+  const ECS::Entity id = Unit(pos, *this).id;
+  _spatialIndex.insert(id, pos, Faction::UNIT);
+  wakeAround(pos);
   return true;
 }
 
@@ -158,15 +34,22 @@ bool World::addEnemy(glm::vec2 pos) {
   if (not _region.inBounds(pos)) {
     return false;
   }
+  _touchAround(mapCoordsToTile(pos));
 
-  _enemies.emplace_back(pos, *this);
-  _enemies.back().pathTo({world_size / 2.f, world_size / 2.f});
+  Enemy enemy(pos, *this);
+  _spatialIndex.insert(enemy.id, pos, Faction::ENEMY);
+  wakeAround(pos);
+  enemy.pathTo(glm::vec2(centerCell()));
   return true;
 }
 
 bool World::addStructure(glm::ivec2 cell, StructureType t) {
   if (not _region.inBounds({cell.x, cell.y}) or
-      cell == glm::ivec2{world_size / 2, world_size / 2}) {
+      cell == centerCell()) {
+    return false;
+  }
+
+  if (_region.structureAt(cell) != ECS::InvalidEntityId) {
     return false;
   }
 
@@ -178,109 +61,78 @@ bool World::addStructure(glm::ivec2 cell, StructureType t) {
   // Subtract the cost from the player's resource account
   _resources -= cost;
 
-  _structures.emplace_back(cell, *this, t);
-  _region.addStructure(cell);
-
-  for (auto& u : _units) {
-    u.repath();
-  }
-
-  for (auto& u : _enemies) {
-    u.repath();
-  }
+  const Structure structure(cell, *this, t);
+  // indexed at its middle like units and enemies, though its transform sits at the tile corner
+  _spatialIndex.insert(structure.id, centerOfTile(cell), Faction::STRUCTURE);
+  _region.addStructure(cell, structure.id);
+  wakeAround(centerOfTile(cell));
 
+  _repathMovers();
   return true;
 }
 
-bool World::removeUnit(ECS::Entity id) {
-  bool found = false;
-
-  for (auto iter = _units.begin(); iter < _units.end(); ++iter) {
-    if (iter->id == id) {
-      _units.erase(iter);
-      found = true;
-
-      break;
-    }
+bool World::remove(ECS::Entity id) {
+  const Faction faction = _remove(id);
+  if (faction == Faction::STRUCTURE) {
+    _repathMovers(); // whether it was sold or destroyed, there may be a shorter way through now
   }
-
-  return found && ECS::Manager::deleteEntity(id);
+  return faction != Faction::NONE;
 }
 
-bool World::removeEnemy(ECS::Entity id) {
-  bool found = false;
-
-  for (auto iter = _enemies.begin(); iter < _enemies.end(); ++iter) {
-    if (iter->id == id) {
-      _enemies.erase(iter);
-      found = true;
-
-      break;
-    }
+std::size_t World::remove(const std::vector<ECS::Entity>& ids) {
+  std::size_t removed = 0;
+  bool structureGone = false;
+  for (ECS::Entity id : ids) {
+    const Faction faction = _remove(id);
+    removed += faction != Faction::NONE;
+    structureGone = structureGone || faction == Faction::STRUCTURE;
   }
-
-  return found && ECS::Manager::deleteEntity(id);
+  if (structureGone) {
+    _repathMovers();
+  }
+  return removed;
 }
 
-bool World::removeStructure(ECS::Entity id) {
-  bool found = false;
-
-  for (auto iter = _structures.begin(); iter < _structures.end(); ++iter) {
-    if (iter->id == id) {
-      _region.removeStructure(iter->pos());
-      _structures.erase(iter);
-      found = true;
-
-      break;
-    }
+Faction World::_remove(ECS::Entity id) {
+  // it stays on the roster until the Manager unregisters it at the end of the update
+  const Faction faction = _roster.factionOf(id);
+  if (faction == Faction::NONE || not ECS::Manager::deleteEntity(id)) {
+    return Faction::NONE;
   }
 
-  return found && ECS::Manager::deleteEntity(id);
+  if (faction == Faction::STRUCTURE) {
+    _region.removeStructure(glm::ivec2(ECS::Manager::getComponent<TransformComponent>(id).pos));
+  }
+  _spatialIndex.remove(id);
+  return faction;
 }
 
 bool World::sellStructure(glm::ivec2 cell) {
   bool found = false;
 
-  ECS::Entity id = ECS::InvalidEntityId;
-  ResourceType cost;
-  for (auto iter = _structures.begin(); iter < _structures.end(); ++iter) {
-    if (iter->pos() == glm::vec2{cell}) {
-      id = iter->id;
-      cost = iter->cost;
-
-      break;
-    }
-  }
-
+  const ECS::Entity id = _region.structureAt(cell);
   if (id == ECS::InvalidEntityId) {
     return found;
   }
 
-  found = removeStructure(id);
+  const StructureType type = ECS::Manager::getComponent<StructureComponent>(id).structureType;
+  found = remove(id);
 
   if (found) {
-    _resources += cost / sell_ratio;
-  }
-
-  for (auto& u : _units) {
-    u.repath();
-  }
-
-  for (auto& u : _enemies) {
-    u.repath();
+    _resources += StructureProperties::of(type).cost / sell_ratio;
   }
 
   return found;
 }
 
-Structure* World::structureAt(glm::ivec2 cell) {
-  // TODO: Region::structureAt seemed to have stale data after Game::restart()
-  // also, why is structure data split across world and region?
+ECS::Entity World::structureAt(glm::ivec2 cell) const {
+  return _region.structureAt(cell);
+}
 
-  for (Structure& s : _structures) {
-    if (Game::mapCoordsToTile(s.pos()) == cell) {
-      return &s;
+void World::_repathMovers() {
+  for (Faction movers : {Faction::UNIT, Faction::ENEMY}) {
+    for (ECS::Entity id : _roster.members(movers)) {
+      ECS::Manager::getComponent<MotionComponent>(id).repath();
     }
   }
-  return nullptr;
 }
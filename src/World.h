@@ -1,23 +1,30 @@
 #pragma once
 
 #include "Enemy.h"
-#include "Graphics.h"
+#include "FactionRoster.h"
+#include "PathCache.h"
 #include "Region.h"
 #include "RegionGenerator.h"
+#include "SpatialIndex.h"
 #include "Structure.h"
 #include "Unit.h"
 
+#include <algorithm>
+#include <vector>
+
+class TextureBatch;
+class View;
+
 class World {
   Region _region; // this should be a square
-
-  std::vector<Unit> _units;
-  std::vector<Enemy> _enemies;
-  std::vector<Structure> _structures;
+  PathCache _pathCache;
+  SpatialIndex _spatialIndex; // units, enemies and structures by position
+  FactionRoster _roster;      // units, enemies and structures by faction, kept by the ECS
 
   ResourceType& _resources;
 
-  void _drawUnits(TextureBatch& batch) const;
-  void _drawEnemies(TextureBatch& batch) const;
+  void _drawUnits(TextureBatch& batch, float alpha) const;
+  void _drawEnemies(TextureBatch& batch, float alpha) const;
   void _drawStructures(TextureBatch& batch) const;
   void _drawDebug(View& view) const;
 
@@ -28,34 +35,48 @@ class World {
       v.x = 0;
       result = false;
     }
-    if (v.x >= world_size) {
-      v.x = world_size - 1;
+    if (v.x >= _region.size()) {
+      v.x = _region.size() - 1;
       result = false;
     }
     if (0 > v.y) {
       v.y = 0;
       result = false;
     }
-    if (v.y >= world_size) {
-      v.y = world_size - 1;
+    if (v.y >= _region.size()) {
+      v.y = _region.size() - 1;
       result = false;
     }
     return result;
   }
 
+  // generates the chunks around a mover spawning on cell, so it has ground to stand on
+  void _touchAround(glm::ivec2 cell) {
+    _region.touch(cell - 2, cell + 2);
+  }
+
+  // after building or removing a structure, every path may have to go another way
+  void _repathMovers();
+
+  // remove() but for repathing; the faction id was on, or Faction::NONE if it wasn't removed
+  Faction _remove(ECS::Entity id);
+
   friend class Game;
+  friend class FactionRosterSystem;
 
 public:
-  World(size_t size, ResourceType& resources)
-      : _region({size, std::vector<Tile>(size, Tile::GRASS)}), _resources(resources) {
+  /// a generated size by size map
+  World(int size, ResourceType& resources)
+      : _region(size), _spatialIndex(size), _resources(resources) {
     RegionGenerator().generate(_region);
   }
 
   World& operator=(World&& other) {
-    _units = other._units;
-    _enemies = other._enemies;
-    _structures = other._structures;
+    _region = std::move(other._region);
+    _roster = std::move(other._roster);
     _resources = other._resources;
+    _pathCache.clear();
+    _spatialIndex = std::move(other._spatialIndex);
 
     return *this;
   }
@@ -64,70 +85,80 @@ public:
     return _region;
   }
 
-  static void tileHolo(View& view, glm::ivec2 tile_index) {
-    glm::vec2 offset(-0.5, -0.5);
+  /// tiles along each side of the map
+  int size() const {
+    return _region.size();
+  }
 
-    RectangleBatch()
-        .add()
-        .position(glm::vec2(tile_index.x * tile_size, tile_index.y * tile_size) -
-                  offset * tile_size)
-        .color({.7, .7, .7, .5})
-        .size({tile_size, tile_size})
-        .draw(view);
+  /// the middle of the map, where the base is and enemies head
+  glm::ivec2 centerCell() const {
+    return glm::ivec2(size() / 2, size() / 2);
   }
 
-  void structHolo(View& view, glm::ivec2 p) {
-    const glm::vec2 offset(-0.5, -0.5);
-    const glm::vec4 buildColor{.7, .7, .7, .5};
-    const glm::vec4 occupiedColor{1, .3, .3, .5};
+  PathCache& pathCache() {
+    return _pathCache;
+  }
 
-    const glm::vec4 color = _region.structureAt(p) ? occupiedColor : buildColor;
+  SpatialIndex& spatialIndex() {
+    return _spatialIndex;
+  }
 
-    RectangleBatch()
-        .add()
-        .position(glm::vec2(p.x * tile_size, p.y * tile_size) - offset * tile_size)
-        .color(color)
-        .size({tile_size, tile_size})
-        .draw(view);
+  const FactionRoster& roster() const {
+    return _roster;
   }
 
-  Tile flipCell(glm::ivec2 v) {
-    _snapToRegion(v);
-    return _region[v.x][v.y] = (_region[v.x][v.y] == Tile::GRASS) ? Tile::WATER : Tile::GRASS;
+  const std::vector<ECS::Entity>& units() const {
+    return _roster.members(Faction::UNIT);
   }
 
-  void setCell(glm::ivec2 v, Tile t) {
-    _snapToRegion(v);
-    _region[v.x][v.y] = t;
+  const std::vector<ECS::Entity>& enemies() const {
+    return _roster.members(Faction::ENEMY);
+  }
+
+  const std::vector<ECS::Entity>& structures() const {
+    return _roster.members(Faction::STRUCTURE);
   }
 
-  virtual void draw(TextureBatch& batch, View& view, bool debug) {
-    batch.clear();
-    batch.view(view);
+  // how much closer two movers can get without either crossing into another SpatialIndex bucket
+  static constexpr float wake_margin = 2 * SpatialIndex::bucket_size * tile_size * 1.415f;
+  // wider than any attack range by wake_margin, so nothing sleeps through a hostile closing in
+  static float wakeRadius() {
+    return UnitProperties::longestAttackRange() + wake_margin;
+  }
 
-    _region.draw(batch);
-    _drawStructures(batch);
-    _drawEnemies(batch);
-    _drawUnits(batch);
+  /// wakes every unit, enemy and structure within wakeRadius() of pos
+  void wakeAround(glm::vec2 pos);
 
-    batch.update();
-    batch.draw();
+  static void tileHolo(View& view, glm::ivec2 tile_index);
+  void structHolo(View& view, glm::ivec2 p);
 
-    if (debug) {
-      _drawDebug(view);
-    }
+  Tile flipCell(glm::ivec2 v) {
+    _snapToRegion(v);
+    const Tile t = (_region.at(v) == Tile::GRASS) ? Tile::WATER : Tile::GRASS;
+    _region.setCell(v, t);
+    return t;
+  }
+
+  void setCell(glm::ivec2 v, Tile t) {
+    _snapToRegion(v);
+    _region.setCell(v, t);
   }
 
+  /// alpha blends movers between the last two simulation steps, see ECS::System::render
+  void draw(TextureBatch& batch, View& view, bool debug, float alpha = 1);
+
   bool addUnit(glm::vec2 pos);
   bool addEnemy(glm::vec2 pos);
   bool addStructure(glm::ivec2 cell, StructureType t = StructureType::DEFAULT);
 
-  bool removeUnit(ECS::Entity id);
-  bool removeEnemy(ECS::Entity id);
-  bool removeStructure(ECS::Entity id);
+  /// removes a unit, enemy or structure, whichever id is; removing a structure repaths movers
+  bool remove(ECS::Entity id);
+  /// removes all of ids, repathing movers once at the end if any was a structure
+  std::size_t remove(const std::vector<ECS::Entity>& ids);
 
   bool sellStructure(glm::ivec2 cell);
 
-  Structure* structureAt(glm::ivec2 cell);
+  /// the structure entity on cell, or ECS::InvalidEntityId
+  ECS::Entity structureAt(glm::ivec2 cell) const;
   // bool unitAt(glm::ivec2 cell);
 };
@@ -0,0 +1,238 @@
+#include "Graphics.h"
+#include "Tile.h"
+#include "Unit.h"
+#include "World.h"
+
+// Everything the simulation draws, kept apart so fortress-sim links without graphics
+
+void World::draw(TextureBatch& batch, View& view, bool debug, float alpha) {
+  batch.clear();
+  batch.view(view);
+
+  _region.draw(batch);
+  _drawStructures(batch);
+  _drawEnemies(batch, alpha);
+  _drawUnits(batch, alpha);
+
+  batch.update();
+  batch.draw();
+
+  if (debug) {
+    _drawDebug(view);
+  }
+}
+
+void World::tileHolo(View& view, glm::ivec2 tile_index) {
+  glm::vec2 offset(-0.5, -0.5);
+
+  RectangleBatch()
+      .add()
+      .position(glm::vec2(tile_index.x * tile_size, tile_index.y * tile_size) -
+                offset * tile_size)
+      .color({.7, .7, .7, .5})
+      .size({tile_size, tile_size})
+      .draw(view);
+}
+
+void World::structHolo(View& view, glm::ivec2 p) {
+  const glm::vec2 offset(-0.5, -0.5);
+  const glm::vec4 buildColor{.7, .7, .7, .5};
+  const glm::vec4 occupiedColor{1, .3, .3, .5};
+
+  const glm::vec4 color = _region.structureAt(p) ? occupiedColor : buildColor;
+
+  RectangleBatch()
+      .add()
+      .position(glm::vec2(p.x * tile_size, p.y * tile_size) - offset * tile_size)
+      .color(color)
+      .size({tile_size, tile_size})
+      .draw(view);
+}
+
+void World::_drawUnits(TextureBatch& batch, float alpha) const {
+  const glm::vec4 selectedCol{.53, .53, .82, 1}, unselectedCol{.2, .4, .6, 1},
+      attackingColor{1, 1, 1, 1};
+
+  // clang-format off
+  for (ECS::Entity id : units()) {
+    float attackTimer = ECS::Manager::getComponent<AttackComponent>(id).attackTimer;
+    
+    //TODO: make bullets flash instead of selection
+
+    const auto& transform = ECS::Manager::getComponent<TransformComponent>(id);
+
+    auto baseColor = unselectedCol;
+    if (ECS::Manager::getComponent<SelectableComponent>(id).selected) {
+      baseColor = selectedCol;
+    } else if (attackTimer < muzzleFlashTime) {
+      baseColor = attackingColor;
+    }
+    
+    TextureBatch::Instance inst;
+    inst.pos = transform.renderPos(alpha);
+    inst.size = {tile_size, tile_size};
+    inst.aColor = baseColor;
+    inst.rotation = transform.renderRot(alpha);
+    batch.add(std::move(inst));
+  }
+  // clang-format on
+}
+
+void World::_drawEnemies(TextureBatch& batch, float alpha) const {
+  const glm::vec4 enemyCol{.85, .36, .22, 1}, attackingColor{1, 1, 1, 1};
+
+  // clang-format off
+  for (ECS::Entity id : enemies()) {
+    float attackTimer = ECS::Manager::getComponent<AttackComponent>(id).attackTimer;
+
+    const auto& transform = ECS::Manager::getComponent<TransformComponent>(id);
+
+    auto baseColor = enemyCol;
+    if (attackTimer < muzzleFlashTime) {
+      baseColor = attackingColor;
+    }
+
+    TextureBatch::Instance inst;
+    inst.pos = transform.renderPos(alpha);
+    inst.size = {tile_size, tile_size};
+    inst.aColor = baseColor;
+    inst.rotation = transform.renderRot(alpha);
+    batch.add(std::move(inst));
+  }
+  // clang-format on
+}
+
+void World::_drawDebug(View& view) const {
+  RectangleBatch rectangles;
+
+  constexpr float pathMarkerSize = 0.8;
+  glm::vec2 pathTileSize(tile_size * pathMarkerSize, tile_size * pathMarkerSize);
+
+  glm::vec2 pathTileOffset(0.5 * pathMarkerSize * tile_size, 0.5 * pathMarkerSize * tile_size);
+  pathTileOffset -= glm::vec2(0.5, 0.5) * (tile_size * pathMarkerSize);
+
+  for (ECS::Entity id : enemies()) {
+    const auto& motion = ECS::Manager::getComponent<MotionComponent>(id);
+    auto& path = motion.path;
+    const std::size_t next = motion.waypoint;
+    for (std::size_t i = next; i < path.size(); ++i) {
+      rectangles.add()
+          .position(centerOfTile(path[i]) - pathTileOffset)
+          .size(pathTileSize)
+          .color({1, 0, 0, 0.3});
+    }
+
+    if (next < path.size()) {
+      auto target = path[next];
+      rectangles.add()
+          .position(centerOfTile(target) - pathTileOffset)
+          .size(pathTileSize)
+          .color({0, 0, 1, 0.3});
+
+      LineBatch()
+          .add()
+          .points(ECS::Manager::getComponent<TransformComponent>(id).pos, centerOfTile(target))
+          .lineWidth(0.2)
+          .color({1, 0, 1, 1})
+          .draw(view);
+    }
+  }
+
+  for (ECS::Entity id : units()) {
+    const auto& motion = ECS::Manager::getComponent<MotionComponent>(id);
+    auto& path = motion.path;
+    const std::size_t next = motion.waypoint;
+    for (std::size_t i = next; i < path.size(); ++i) {
+      rectangles.add()
+          .position(centerOfTile(path[i]) - pathTileOffset)
+          .size(pathTileSize)
+          .color({1, 0, 0, 0.3});
+    }
+
+    if (next < path.size()) {
+      auto target = path[next];
+      rectangles.add()
+          .position(centerOfTile(target) - pathTileOffset)
+          .size(pathTileSize)
+          .color({0, 0, 1, 0.3});
+    }
+  }
+  rectangles.draw(view);
+}
+
+void World::_drawStructures(TextureBatch& batch) const {
+  const glm::vec2 offset(-tile_size * 0.5, -tile_size * 0.5);
+
+  for (ECS::Entity id : structures()) {
+    const StructureType type = ECS::Manager::getComponent<StructureComponent>(id).structureType;
+
+    TextureBatch::Instance inst;
+    inst.pos = ECS::Manager::getComponent<TransformComponent>(id).pos * tile_size - offset;
+    inst.size = {tile_size, tile_size};
+    inst.texOffset = static_cast<float>(StructureProperties::of(type).texOffset);
+    batch.add(std::move(inst));
+  }
+}
+
+void Region::draw(TextureBatch& batch) {
+  const glm::vec2 offset(-tile_size * 0.5, -tile_size * 0.5);
+  View& view = batch.view();
+
+  // cpu view culling: only visit the tiles under the view
+  const glm::ivec2 lo = glm::max(
+      glm::ivec2(glm::floor(glm::vec2(view.left(), view.bottom()) / tile_size)), glm::ivec2(0));
+  const glm::ivec2 hi = glm::min(
+      glm::ivec2(glm::floor(glm::vec2(view.right(), view.top()) / tile_size)),
+      glm::ivec2(_size - 1));
+  if (lo.x > hi.x || lo.y > hi.y) {
+    return;
+  }
+
+  // generate first, so looking tiles up below doesn't add to the journal while it's being read
+  touch(lo, hi);
+
+  // a still view only looks up the tiles changed since last time
+  const bool sameView = lo == _drawnLo && hi == _drawnHi;
+  if (not sameView ||
+      not _changes.forEachSince(_drawnVersion, [&](const ChangeJournal::Change& change) {
+        _redrawTiles(glm::max(change.lo, lo), glm::min(change.hi, hi));
+      })) {
+    _drawnLo = lo;
+    _drawnHi = hi;
+    _drawnTextures.resize(static_cast<std::size_t>(hi.x - lo.x + 1) * (hi.y - lo.y + 1));
+    _redrawTiles(lo, hi);
+  }
+  _drawnVersion = _changes.version();
+
+  const float* texture = _drawnTextures.data();
+  for (int j = lo.y; j <= hi.y; ++j) {
+    for (int i = lo.x; i <= hi.x; ++i) {
+      auto pos = glm::vec2{i * tile_size, j * tile_size} - offset;
+
+      TextureBatch::Instance inst;
+      inst.pos = pos;
+      inst.size = {tile_size, tile_size};
+      inst.texOffset = *texture++;
+      batch.add(std::move(inst));
+    }
+  }
+}
+
+void Region::_redrawTiles(glm::ivec2 lo, glm::ivec2 hi) {
+  const int width = _drawnHi.x - _drawnLo.x + 1;
+  for (int j = lo.y; j <= hi.y; ++j) {
+    for (int i = lo.x; i <= hi.x; ++i) {
+      _drawnTextures[static_cast<std::size_t>(j - _drawnLo.y) * width + (i - _drawnLo.x)] =
+          TileProperties::of(_tile({i, j})).texOffset;
+    }
+  }
+}
+
+void Unit::holo(View& view, glm::vec2 curr) {
+  CircleBatch()
+      .add()
+      .position(curr)
+      .size({tile_size, tile_size})
+      .color({1, 0.5, 0.5, 0.5})
+      .draw(view);
+}
@@ -1,6 +1,18 @@
+#include "Definitions.h"
 #include "Game.h"
 
+#include <iostream>
+#include <stdexcept>
+
 int main() {
+  // before Game, so the world is generated with the loaded tiles
+  try {
+    loadDefinitionsFile("data/definitions.txt");
+  } catch (const std::runtime_error& e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+
   Game g;
 
   g.loop();